@@ -0,0 +1,19 @@
+#pragma once
+#include <vector>
+
+/*
+    Result of StationGraph::GetBetweenness. Every departure carries one journey to each other station it can reach,
+    so a pair served all day weighs more than one served once. A journey is split evenly across its tied earliest
+    arriving routes from that departure (layovers included, as GetRouteFromTime weighs them), and each score is the
+    share of those journeys that passes through the station or rides the train.
+*/
+
+struct BetweennessScores {
+    // Journeys changing trains at or passing through each station, by station id - 1. Journeys starting or ending
+    // at the station don't count towards it.
+    std::vector<double> stationScores;
+    // Journeys riding each departure, by departure key, including the journeys boarding it at their origin.
+    std::vector<double> departureScores;
+    // Departure and destination station pairs with a route, the total number of journeys counted.
+    long long journeyCount;
+};
@@ -0,0 +1,220 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <cctype>
+
+/*
+    Bounded station graph is a fixed capacity companion to StationGraph for networks that stay within the limits
+    the data files promise (station ids 1 to 199, names of at most 25 characters). Every table is a std::array sized
+    at compile time, names are stored in fixed width slots and reachability is kept as one bitset per station, so the
+    whole model is a few kilobytes, sits in cache, and service/name queries never touch the heap.
+
+    Reachability follows the same rules as the departure graph: a train can be boarded at a station if it departs
+    strictly after the arrival there. It is computed once at construction by processing trips from the latest
+    departure to the earliest, so every connection a trip could make has already been resolved.
+
+    Route finding still goes through StationGraph, this only answers existence and lookup queries.
+*/
+
+template<int MaxStationID, int MaxNameLength>
+class BoundedStationGraph{
+    public:
+        typedef std::bitset<MaxStationID + 1> StationSet;
+
+        BoundedStationGraph(const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<std::vector<std::string>>& stationDataTable);
+        // Returns true if every station id and name in the data fits within the compile time bounds.
+        static bool NetworkFits(const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<std::vector<std::string>>& stationDataTable);
+        bool DirectPathExists(int station1ID, int station2ID) const;
+        bool PathExists(int startStationID, int targetStationID) const;
+        const StationSet& ReachableStations(int stationID) const;
+        // Returns station id for given station name, or -1 if there is no match.
+        int StationIdLookup(const std::string& stationName) const;
+        const char* StationNameLookup(int stationID) const;
+    private:
+        std::array<std::array<char, MaxNameLength + 1>, MaxStationID + 1> stationNames;
+        std::array<StationSet, MaxStationID + 1> directReach;
+        std::array<StationSet, MaxStationID + 1> reach;
+        StationSet validStations;
+
+        static bool id_in_bounds(int stationID);
+        static bool names_match(const char* storedName, const std::string& stationName);
+        void build_station_names(const std::vector<std::vector<std::string>>& stationDataTable);
+        void build_reachability(const std::vector<std::vector<std::string>>& tripDataTable);
+};
+
+// Sized for the limits documented for stations.dat.
+typedef BoundedStationGraph<199, 25> RegionalStationGraph;
+
+template<int MaxStationID, int MaxNameLength>
+BoundedStationGraph<MaxStationID, MaxNameLength>::BoundedStationGraph(const std::vector<std::vector<std::string>>& tripDataTable,
+    const std::vector<std::vector<std::string>>& stationDataTable)
+{
+    build_station_names(stationDataTable);
+    build_reachability(tripDataTable);
+}
+
+template<int MaxStationID, int MaxNameLength>
+bool BoundedStationGraph<MaxStationID, MaxNameLength>::id_in_bounds(int stationID)
+{
+    return stationID > 0 && stationID <= MaxStationID;
+}
+
+// Same matching rules as Utility::CompareStringsNoCase, without building a std::string from the stored name.
+template<int MaxStationID, int MaxNameLength>
+bool BoundedStationGraph<MaxStationID, MaxNameLength>::names_match(const char* storedName, const std::string& stationName)
+{
+    int i = 0;
+    for(; i < stationName.size(); i++)
+    {
+        char c1 = storedName[i];
+        char c2 = stationName[i];
+        if(c1 == '\0')
+        {
+            return false;
+        }
+
+        // Treat space and _ as same character in string comparisons.
+        if((c1 == '_' && c2 == ' ') || (c2 == '_' && c1 == ' '))
+        {
+            continue;
+        }
+
+        if(tolower(c1) != tolower(c2))
+        {
+            return false;
+        }
+    }
+    return storedName[i] == '\0';
+}
+
+template<int MaxStationID, int MaxNameLength>
+bool BoundedStationGraph<MaxStationID, MaxNameLength>::NetworkFits(const std::vector<std::vector<std::string>>& tripDataTable,
+    const std::vector<std::vector<std::string>>& stationDataTable)
+{
+    for(int i = 0; i < stationDataTable.size(); i++)
+    {
+        if(stationDataTable[i].size() < 2 || !id_in_bounds(stoi(stationDataTable[i][0])) || stationDataTable[i][1].size() > MaxNameLength)
+        {
+            return false;
+        }
+    }
+
+    for(int i = 0; i < tripDataTable.size(); i++)
+    {
+        if(!id_in_bounds(stoi(tripDataTable[i][0])) || !id_in_bounds(stoi(tripDataTable[i][1])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<int MaxStationID, int MaxNameLength>
+void BoundedStationGraph<MaxStationID, MaxNameLength>::build_station_names(const std::vector<std::vector<std::string>>& stationDataTable)
+{
+    for(int i = 0; i <= MaxStationID; i++)
+    {
+        stationNames[i].fill('\0');
+    }
+
+    for(int i = 0; i < stationDataTable.size(); i++)
+    {
+        int stationID = stoi(stationDataTable[i][0]);
+        std::copy(stationDataTable[i][1].begin(), stationDataTable[i][1].end(), stationNames[stationID].begin());
+        validStations.set(stationID);
+    }
+}
+
+template<int MaxStationID, int MaxNameLength>
+void BoundedStationGraph<MaxStationID, MaxNameLength>::build_reachability(const std::vector<std::vector<std::string>>& tripDataTable)
+{
+    struct TripRow { int startID; int destinationID; int departureTime; int arrivalTime; };
+
+    std::vector<TripRow> tripTable;
+    for(int i = 0; i < tripDataTable.size(); i++)
+    {
+        tripTable.push_back({stoi(tripDataTable[i][0]), stoi(tripDataTable[i][1]), stoi(tripDataTable[i][2]), stoi(tripDataTable[i][3])});
+    }
+
+    // Latest departure first, so any train a trip connects to has already been processed.
+    std::sort(tripTable.begin(), tripTable.end(), [](const TripRow& a, const TripRow& b) { return a.departureTime > b.departureTime; });
+
+    // Per station, departures processed so far (in decreasing time) and the running union of what they reach.
+    // The trains leaving strictly after a given arrival are always a prefix of these lists.
+    std::vector<std::vector<int>> stationDepartureTimes(MaxStationID + 1);
+    std::vector<std::vector<StationSet>> stationReachPrefix(MaxStationID + 1);
+
+    for(int i = 0; i < MaxStationID + 1; i++)
+    {
+        directReach[i].reset();
+        reach[i].reset();
+    }
+
+    for(const TripRow& trip : tripTable)
+    {
+        StationSet tripReach;
+        tripReach.set(trip.destinationID);
+
+        const std::vector<int>& connectingTimes = stationDepartureTimes[trip.destinationID];
+        int connectingCount = std::lower_bound(connectingTimes.begin(), connectingTimes.end(), trip.arrivalTime, std::greater<int>()) - connectingTimes.begin();
+        if(connectingCount > 0)
+        {
+            tripReach |= stationReachPrefix[trip.destinationID][connectingCount - 1];
+        }
+
+        std::vector<StationSet>& prefix = stationReachPrefix[trip.startID];
+        prefix.push_back(prefix.size() > 0 ? (prefix.back() | tripReach) : tripReach);
+        stationDepartureTimes[trip.startID].push_back(trip.departureTime);
+
+        directReach[trip.startID].set(trip.destinationID);
+        reach[trip.startID] |= tripReach;
+    }
+}
+
+template<int MaxStationID, int MaxNameLength>
+bool BoundedStationGraph<MaxStationID, MaxNameLength>::DirectPathExists(int station1ID, int station2ID) const
+{
+    return id_in_bounds(station1ID) && id_in_bounds(station2ID) && directReach[station1ID].test(station2ID);
+}
+
+template<int MaxStationID, int MaxNameLength>
+bool BoundedStationGraph<MaxStationID, MaxNameLength>::PathExists(int startStationID, int targetStationID) const
+{
+    return id_in_bounds(startStationID) && id_in_bounds(targetStationID) && reach[startStationID].test(targetStationID);
+}
+
+template<int MaxStationID, int MaxNameLength>
+const typename BoundedStationGraph<MaxStationID, MaxNameLength>::StationSet& BoundedStationGraph<MaxStationID, MaxNameLength>::ReachableStations(int stationID) const
+{
+    return reach[id_in_bounds(stationID) ? stationID : 0];
+}
+
+template<int MaxStationID, int MaxNameLength>
+int BoundedStationGraph<MaxStationID, MaxNameLength>::StationIdLookup(const std::string& stationName) const
+{
+    if(stationName.size() > MaxNameLength)
+    {
+        return -1;
+    }
+
+    for(int i = 1; i <= MaxStationID; i++)
+    {
+        if(validStations.test(i) && names_match(stationNames[i].data(), stationName))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+template<int MaxStationID, int MaxNameLength>
+const char* BoundedStationGraph<MaxStationID, MaxNameLength>::StationNameLookup(int stationID) const
+{
+    return id_in_bounds(stationID) && validStations.test(stationID) ? stationNames[stationID].data() : "INVALID";
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+/*
+    One row of StationGraph::GetClosureImpacts, the effect of closing a single station or a single train on every
+    origin-destination pair of the network. Pairs are weighed with layovers included, the same weight
+    GetShortestRoute(..., true) reports, and pairs that start or end at a closed station are not counted.
+*/
+
+struct ClosureImpact {
+    // Closed station, or -1 when a train was closed.
+    int stationID;
+    // Departure key of the closed train, or -1 when a station was closed.
+    int departureKey;
+    // Pairs with a route before the closure and none after.
+    int disconnectedPairs;
+    // Extra minutes summed over the pairs that still have a route.
+    long long addedMinutes;
+    // Origins whose shortest paths used the closed station or train, the only ones searched again.
+    int recomputedOrigins;
+};
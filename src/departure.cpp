@@ -0,0 +1,108 @@
+#include <algorithm>
+#include "departure.hpp"
+#include "utility.hpp"
+
+const TripPlusLayover Departure::invalidTrip = {-1, 0, 0, 0};
+
+Departure::Departure(std::vector<TripPlusLayover> tripArray, int ID, int key, int departure)
+{
+    validTrips = tripArray;
+    // Stable so duplicate edges keep their original order, first match wins the same as a linear scan would.
+    std::stable_sort(validTrips.begin(), validTrips.end(),
+        [](const TripPlusLayover& a, const TripPlusLayover& b) { return a.destinationKey < b.destinationKey; });
+    stationID = ID;
+    lookUpKey = key;
+    departureTime = departure;
+    cancelled = false;
+}
+
+int Departure::GetDepartureTime() const
+{
+    return departureTime;
+}
+
+bool Departure::IsFinalDestination() const
+{
+    return validTrips.size() == 0;
+}
+
+int Departure::GetLookUpKey() const
+{
+    return lookUpKey;
+}
+
+void Departure::PrefetchTrips() const
+{
+    if(validTrips.size() > 0)
+    {
+        Utility::Prefetch(validTrips.data());
+    }
+}
+
+const TripPlusLayover& Departure::FindTripByDestinationKey(int destinationKey) const
+{
+    int count = validTrips.size();
+    if(count == 0)
+    {
+        return invalidTrip;
+    }
+
+    // Branch-free lower bound, the loop only moves the base pointer with a conditional select
+    // so hub departures with thousands of edges don't pay for mispredicted branches.
+    const TripPlusLayover* base = validTrips.data();
+    while(count > 1)
+    {
+        int half = count / 2;
+        base = (base[half].destinationKey < destinationKey) ? base + half : base;
+        count -= half;
+    }
+    base += (base->destinationKey < destinationKey);
+
+    if(base != validTrips.data() + validTrips.size() && base->destinationKey == destinationKey)
+    {
+        return *base;
+    }
+
+    return invalidTrip;
+}
+
+bool Departure::IsCancelled() const
+{
+    return cancelled;
+}
+
+void Departure::Cancel()
+{
+    cancelled = true;
+}
+
+bool Departure::RemoveTripTo(int destinationKey)
+{
+    // Trips are sorted by destination key, duplicates sit together.
+    std::vector<TripPlusLayover>::iterator first = std::lower_bound(validTrips.begin(), validTrips.end(), destinationKey,
+        [](const TripPlusLayover& trip, int key) { return trip.destinationKey < key; });
+    std::vector<TripPlusLayover>::iterator last = first;
+    while(last != validTrips.end() && last->destinationKey == destinationKey)
+    {
+        ++last;
+    }
+
+    bool removed = first != last;
+    validTrips.erase(first, last);
+    return removed;
+}
+
+TripPlusLayover Departure::GetTrip(int tripIndex) const
+{
+    return validTrips[tripIndex];
+}
+
+int Departure::GetTripCount() const
+{
+    return validTrips.size();
+}
+
+int Departure::GetStationID() const
+{
+    return stationID;
+}
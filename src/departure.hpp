@@ -10,62 +10,22 @@ class Departure {
         int GetDepartureTime() const;
         bool IsFinalDestination() const;
         TripPlusLayover GetTrip(int tripIndex) const;
-        TripPlusLayover FindTripByDestinationKey(int destinationKey) const;
+        // Binary search over trips sorted by destination key. Returns a trip with destinationKey -1 if there is no match.
+        const TripPlusLayover& FindTripByDestinationKey(int destinationKey) const;
+        // Starts loading the first edges so a scan or FindTripByDestinationKey shortly after doesn't wait on memory.
+        void PrefetchTrips() const;
+        // Scenario edits, see StationGraph::CancelDeparture. A cancelled departure can't be boarded.
+        bool IsCancelled() const;
+        void Cancel();
+        // Drops the edges to destinationKey. Returns false if there were none.
+        bool RemoveTripTo(int destinationKey);
         Departure(std::vector<TripPlusLayover> tripArray, int ID, int key, int departure);
     private:
+        // Sorted by destinationKey at construction.
         std::vector<TripPlusLayover> validTrips;
         int lookUpKey;
         int stationID;
         int departureTime;
+        bool cancelled;
+        static const TripPlusLayover invalidTrip;
 };
-
-Departure::Departure(std::vector<TripPlusLayover> tripArray, int ID, int key, int departure)
-{
-    validTrips = tripArray;
-    stationID = ID;
-    lookUpKey = key;
-    departureTime = departure;
-}
-
-int Departure::GetDepartureTime() const
-{
-    return departureTime;
-}
-
-bool Departure::IsFinalDestination() const
-{
-    return validTrips.size() == 0;
-}
-
-int Departure::GetLookUpKey() const
-{
-    return lookUpKey;
-}
-
-TripPlusLayover Departure::FindTripByDestinationKey(int destinationKey) const
-{
-    for(TripPlusLayover trip : validTrips)
-    {
-        if(trip.destinationKey == destinationKey)
-        {
-            return trip;
-        }
-    }
-
-    return {-1};
-}
-
-TripPlusLayover Departure::GetTrip(int tripIndex) const
-{
-    return validTrips[tripIndex];
-}
-
-int Departure::GetTripCount() const
-{
-    return validTrips.size();
-}
-
-int Departure::GetStationID() const
-{
-    return stationID;
-}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "departure_block_list.hpp"
+
+DepartureBlockList::DepartureBlockList() : departureCount(0), copiedBlockCount(0)
+{
+}
+
+void DepartureBlockList::make_block_private(int block)
+{
+    if(blocks[block].use_count() > 1)
+    {
+        blocks[block] = std::make_shared<std::vector<Departure>>(*blocks[block]);
+        copiedBlockCount++;
+    }
+}
+
+void DepartureBlockList::push_back(const Departure& departure)
+{
+    if((departureCount & (BlockSize - 1)) == 0)
+    {
+        blocks.push_back(std::make_shared<std::vector<Departure>>());
+        blocks.back()->reserve(BlockSize);
+    }
+    else
+    {
+        make_block_private(blocks.size() - 1);
+    }
+
+    blocks.back()->push_back(departure);
+    departureCount++;
+}
+
+size_t DepartureBlockList::size() const
+{
+    return departureCount;
+}
+
+DepartureBlockList::const_iterator DepartureBlockList::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+DepartureBlockList::const_iterator DepartureBlockList::end() const
+{
+    return const_iterator(this, departureCount);
+}
+
+Departure& DepartureBlockList::Mutable(int key)
+{
+    make_block_private(key >> BlockShift);
+    return (*blocks[key >> BlockShift])[key & (BlockSize - 1)];
+}
+
+int DepartureBlockList::GetBlockCount() const
+{
+    return blocks.size();
+}
+
+int DepartureBlockList::GetCopiedBlockCount() const
+{
+    return copiedBlockCount;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "departure.hpp"
+
+/*
+    Departure block list stores the departure graph in fixed size blocks held by shared pointers. Copying a list
+    shares every block, and the first write to a departure copies only the block holding it, so a scenario forked
+    from a graph costs a pointer per block until it is edited and then one block per edited region.
+
+    Reads index a block and then a slot, keys are the same as they were with a flat vector. Writes are not safe
+    while another thread reads or copies the same list.
+*/
+
+class DepartureBlockList{
+    public:
+        // 256 departures per block.
+        static const int BlockShift = 8;
+        static const int BlockSize = 1 << BlockShift;
+
+        class const_iterator{
+            public:
+                const_iterator(const DepartureBlockList* blockList, int key) : list(blockList), currentKey(key) {}
+                const Departure& operator*() const { return (*list)[currentKey]; }
+                const_iterator& operator++() { ++currentKey; return *this; }
+                bool operator!=(const const_iterator& other) const { return currentKey != other.currentKey; }
+            private:
+                const DepartureBlockList* list;
+                int currentKey;
+        };
+
+        DepartureBlockList();
+        void push_back(const Departure& departure);
+        size_t size() const;
+        const Departure& operator[](int key) const
+        {
+            return (*blocks[key >> BlockShift])[key & (BlockSize - 1)];
+        }
+        const_iterator begin() const;
+        const_iterator end() const;
+        // Writable departure, its block is copied first if any other list still shares it.
+        Departure& Mutable(int key);
+        int GetBlockCount() const;
+        // Blocks this list has copied rather than shared since it was created.
+        int GetCopiedBlockCount() const;
+    private:
+        std::vector<std::shared_ptr<std::vector<Departure>>> blocks;
+        size_t departureCount;
+        int copiedBlockCount;
+
+        void make_block_private(int block);
+};
@@ -0,0 +1,98 @@
+#include <sstream>
+#include <iomanip>
+#include "utility.hpp"
+#include "frequency_service.hpp"
+
+namespace {
+    // Whole field must be digits, stoi alone would accept "06x0" as 6 and throw on "abc".
+    bool parse_field(const std::string& field, int& value)
+    {
+        if(field.empty() || field.size() > 9)
+        {
+            return false;
+        }
+        for(char digit : field)
+        {
+            if(digit < '0' || digit > '9')
+            {
+                return false;
+            }
+        }
+
+        value = stoi(field);
+        return true;
+    }
+
+    bool is_twenty_four_time(int twentyFourTime)
+    {
+        return twentyFourTime < 2400 && twentyFourTime % 100 < 60;
+    }
+}
+
+bool FrequencyService::IsFrequencyRecord(const std::vector<std::string>& record)
+{
+    return record.size() > 0 && (record[0] == "F" || record[0] == "f");
+}
+
+bool FrequencyService::FromRecord(const std::vector<std::string>& record, FrequencyService& service)
+{
+    if(!IsFrequencyRecord(record) || record.size() != 7)
+    {
+        return false;
+    }
+
+    if(!parse_field(record[1], service.departureStationID) || !parse_field(record[2], service.destinationStationID)
+        || !parse_field(record[3], service.firstDepartureTime) || !parse_field(record[4], service.lastDepartureTime)
+        || !parse_field(record[5], service.headwayMins) || !parse_field(record[6], service.rideMins)
+        || !is_twenty_four_time(service.firstDepartureTime) || !is_twenty_four_time(service.lastDepartureTime))
+    {
+        return false;
+    }
+
+    int firstMins = Utility::TwentyFourTimeToMinutes(service.firstDepartureTime);
+    int lastMins = Utility::TwentyFourTimeToMinutes(service.lastDepartureTime);
+    return service.departureStationID > 0 && service.destinationStationID > 0
+        && service.departureStationID != service.destinationStationID && service.headwayMins > 0 && service.rideMins > 0
+        && firstMins >= 0 && firstMins <= lastMins && lastMins + service.rideMins < 24 * 60;
+}
+
+void FrequencyService::AppendTripRecords(const std::vector<FrequencyService>& services, std::vector<std::vector<std::string>>& tripDataTable)
+{
+    for(const FrequencyService& service : services)
+    {
+        int departureMins = Utility::TwentyFourTimeToMinutes(service.firstDepartureTime);
+        for(int run = 0; run < service.GetRunCount(); run++, departureMins += service.headwayMins)
+        {
+            // Other readers compare times as strings, keep them four digits.
+            std::stringstream departureTime;
+            std::stringstream arrivalTime;
+            departureTime << std::setw(4) << std::setfill('0') << Utility::MinutesToTwentyFourTime(departureMins);
+            arrivalTime << std::setw(4) << std::setfill('0') << Utility::MinutesToTwentyFourTime(departureMins + service.rideMins);
+            tripDataTable.push_back({std::to_string(service.departureStationID), std::to_string(service.destinationStationID),
+                departureTime.str(), arrivalTime.str()});
+        }
+    }
+}
+
+int FrequencyService::NextDeparture(int twentyFourTime, bool strictlyAfter) const
+{
+    int firstMins = Utility::TwentyFourTimeToMinutes(firstDepartureTime);
+    int earliestMins = Utility::TwentyFourTimeToMinutes(twentyFourTime) + (strictlyAfter ? 1 : 0);
+    int run = earliestMins <= firstMins ? 0 : (earliestMins - firstMins + headwayMins - 1) / headwayMins;
+    if(run >= GetRunCount())
+    {
+        return Utility::INF;
+    }
+
+    return Utility::MinutesToTwentyFourTime(firstMins + run * headwayMins);
+}
+
+int FrequencyService::ArrivalTime(int departureTime) const
+{
+    return Utility::MinutesToTwentyFourTime(Utility::TwentyFourTimeToMinutes(departureTime) + rideMins);
+}
+
+int FrequencyService::GetRunCount() const
+{
+    return (Utility::TwentyFourTimeToMinutes(lastDepartureTime) - Utility::TwentyFourTimeToMinutes(firstDepartureTime)) / headwayMins + 1;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <string>
+
+/*
+    Frequency service is a headway based train written as one record in trains.dat instead of one line per run:
+
+        F <departure id> <destination id> <first departure HHMM> <last departure HHMM> <headway mins> <ride mins>
+
+    e.g. "F 1 2 0600 2200 10 25" runs every 10 minutes from 0600 to 2200 and takes 25 minutes.
+
+    Services are a shorthand of the file format, not of the engines. Every run is expanded by AppendTripRecords at
+    load, so the departure graph, sequence tables, hub labels, regional graph and graph images hold one vertex per
+    run exactly as if trains.dat listed it. Only the route pattern table keeps one record per service and computes
+    runs with NextDeparture. The on-demand engines do not generate runs lazily, they and everything built on them
+    are keyed by departure vertex, and so are a scenario's cancellations and closures.
+*/
+
+struct FrequencyService {
+    int departureStationID;
+    int destinationStationID;
+    // HHMM
+    int firstDepartureTime;
+    int lastDepartureTime;
+    int headwayMins;
+    int rideMins;
+
+    static bool IsFrequencyRecord(const std::vector<std::string>& record);
+    // Parses a frequency record. Returns false if a field is not a whole number, a time is not HHMM or a run would
+    // cross midnight. Station ids are not checked against stations.dat, see Schedule.
+    static bool FromRecord(const std::vector<std::string>& record, FrequencyService& service);
+    // Adds one ordinary trip record per run of every service.
+    static void AppendTripRecords(const std::vector<FrequencyService>& services, std::vector<std::vector<std::string>>& tripDataTable);
+
+    // First run (HHMM) leaving at or after twentyFourTime, or strictly after it. Utility::INF if there is none.
+    int NextDeparture(int twentyFourTime, bool strictlyAfter) const;
+    int ArrivalTime(int departureTime) const;
+    int GetRunCount() const;
+};
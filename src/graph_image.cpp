@@ -0,0 +1,259 @@
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "graph_image.hpp"
+#include "station_graph.hpp"
+
+namespace {
+    const char imageMagic[8] = {'T', 'R', 'N', 'G', 'R', 'A', 'P', 'H'};
+
+    uint64_t align_section(uint64_t offset)
+    {
+        return (offset + 7) & ~(uint64_t)7;
+    }
+
+    void write_padding(std::ofstream& outFile, uint64_t fromOffset)
+    {
+        static const char zeros[8] = {};
+        outFile.write(zeros, align_section(fromOffset) - fromOffset);
+    }
+}
+
+GraphImage::GraphImage(const char* data, size_t bytes)
+{
+    mappedData = data;
+    mappedBytes = bytes;
+}
+
+GraphImage::~GraphImage()
+{
+    if(mappedData)
+    {
+        munmap((void*)mappedData, mappedBytes);
+    }
+}
+
+bool GraphImage::Write(const std::string& path, const std::vector<std::vector<std::string>>& stationDataTable, const StationGraph& graph)
+{
+    // Scenarios have no sequence tables to write, and a background build may not have finished them yet.
+    if(!graph.TablesReady() || !graph.hubLabelIndex)
+    {
+        return false;
+    }
+
+    const RoutePatternTable& patterns = *graph.routePatternTable;
+    const DepartureBlockList& departures = *graph.departureGraphList;
+
+    GraphImageHeader header = {};
+    memcpy(header.magic, imageMagic, sizeof(imageMagic));
+    header.version = imageVersion;
+    header.stationCount = graph.stationCount;
+    header.departureCount = departures.size();
+
+    // Flatten the per station and per departure lists into offset/count records.
+    std::vector<GraphImageStation> stationRecords;
+    std::string nameBlob;
+    std::vector<Trip> stationTrips;
+    for(int i = 0; i < header.stationCount; i++)
+    {
+        std::vector<Trip> trips = patterns.StationDepartures(i + 1);
+        std::string stationName = i < stationDataTable.size() ? stationDataTable[i][1] : "";
+        stationRecords.push_back({i + 1, (int32_t)nameBlob.size(), (int32_t)stationName.size(), header.stationTripCount, (int32_t)trips.size()});
+        nameBlob += stationName;
+        header.stationTripCount += trips.size();
+        stationTrips.insert(stationTrips.end(), trips.begin(), trips.end());
+    }
+    header.nameBytes = nameBlob.size();
+
+    std::vector<GraphImageDeparture> departureRecords;
+    for(const Departure& departure : departures)
+    {
+        departureRecords.push_back({departure.GetStationID(), departure.GetLookUpKey(), departure.GetDepartureTime(),
+            header.edgeCount, departure.GetTripCount(), graph.searchIndexes->recordIndexTable[departure.GetLookUpKey()]});
+        header.edgeCount += departure.GetTripCount();
+    }
+
+    const HubLabelIndex& hubLabels = *graph.hubLabelIndex;
+    uint64_t tableBytes = (uint64_t)header.departureCount * header.departureCount * sizeof(int);
+    uint64_t labelOffsetBytes = (header.departureCount + 1) * sizeof(uint64_t);
+    uint64_t sectionBytes[SectionCount] = {
+        stationRecords.size() * sizeof(GraphImageStation),
+        nameBlob.size(),
+        header.stationTripCount * sizeof(Trip),
+        departureRecords.size() * sizeof(GraphImageDeparture),
+        header.edgeCount * sizeof(TripPlusLayover),
+        tableBytes,
+        tableBytes,
+        labelOffsetBytes,
+        hubLabels.GetOutLabelOffsets()[header.departureCount] * sizeof(HubLabelEntry),
+        labelOffsetBytes,
+        hubLabels.GetInLabelOffsets()[header.departureCount] * sizeof(HubLabelEntry)
+    };
+    uint64_t offset = align_section(sizeof(GraphImageHeader));
+    for(int i = 0; i < SectionCount; i++)
+    {
+        header.sectionOffsets[i] = offset;
+        offset = align_section(offset + sectionBytes[i]);
+    }
+    header.totalBytes = offset;
+
+    // Write under a temporary name and rename, so readers only ever see a complete image.
+    std::string tempPath = path + ".tmp";
+    std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+    if(!outFile.is_open())
+    {
+        return false;
+    }
+
+    outFile.write((const char*)&header, sizeof(header));
+    write_padding(outFile, sizeof(header));
+
+    outFile.write((const char*)stationRecords.data(), sectionBytes[StationSection]);
+    write_padding(outFile, sectionBytes[StationSection]);
+
+    outFile.write(nameBlob.data(), sectionBytes[NameSection]);
+    write_padding(outFile, sectionBytes[NameSection]);
+
+    outFile.write((const char*)stationTrips.data(), sectionBytes[TripSection]);
+    write_padding(outFile, sectionBytes[TripSection]);
+
+    outFile.write((const char*)departureRecords.data(), sectionBytes[DepartureSection]);
+    write_padding(outFile, sectionBytes[DepartureSection]);
+
+    for(const Departure& departure : departures)
+    {
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            TripPlusLayover trip = departure.GetTrip(i);
+            outFile.write((const char*)&trip, sizeof(TripPlusLayover));
+        }
+    }
+    write_padding(outFile, sectionBytes[EdgeSection]);
+
+    outFile.write((const char*)graph.shortestRouteWithLayoverSequenceTable->Data(), tableBytes);
+    write_padding(outFile, tableBytes);
+    outFile.write((const char*)graph.shortestRouteWithoutLayoverSequenceTable->Data(), tableBytes);
+    write_padding(outFile, tableBytes);
+
+    outFile.write((const char*)hubLabels.GetOutLabelOffsets(), sectionBytes[OutLabelOffsetSection]);
+    write_padding(outFile, sectionBytes[OutLabelOffsetSection]);
+    outFile.write((const char*)hubLabels.GetOutLabelEntries(), sectionBytes[OutLabelSection]);
+    write_padding(outFile, sectionBytes[OutLabelSection]);
+    outFile.write((const char*)hubLabels.GetInLabelOffsets(), sectionBytes[InLabelOffsetSection]);
+    write_padding(outFile, sectionBytes[InLabelOffsetSection]);
+    outFile.write((const char*)hubLabels.GetInLabelEntries(), sectionBytes[InLabelSection]);
+    write_padding(outFile, sectionBytes[InLabelSection]);
+
+    outFile.close();
+    if(outFile.fail())
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+GraphImage* GraphImage::Map(const std::string& path)
+{
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if(fileDescriptor < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat fileStatus;
+    if(fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < (off_t)sizeof(GraphImageHeader))
+    {
+        close(fileDescriptor);
+        return nullptr;
+    }
+
+    void* data = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    // The mapping keeps its own reference to the file.
+    close(fileDescriptor);
+    if(data == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    const GraphImageHeader* header = (const GraphImageHeader*)data;
+    if(memcmp(header->magic, imageMagic, sizeof(imageMagic)) != 0 || header->version != imageVersion
+        || header->totalBytes != (uint64_t)fileStatus.st_size)
+    {
+        munmap(data, fileStatus.st_size);
+        return nullptr;
+    }
+
+    return new GraphImage((const char*)data, fileStatus.st_size);
+}
+
+const char* GraphImage::section(Section index) const
+{
+    return mappedData + GetHeader().sectionOffsets[index];
+}
+
+const GraphImageHeader& GraphImage::GetHeader() const
+{
+    return *(const GraphImageHeader*)mappedData;
+}
+
+const GraphImageStation* GraphImage::GetStations() const
+{
+    return (const GraphImageStation*)section(StationSection);
+}
+
+std::string GraphImage::GetStationName(int stationIndex) const
+{
+    const GraphImageStation& station = GetStations()[stationIndex];
+    return std::string(section(NameSection) + station.nameOffset, station.nameLength);
+}
+
+const Trip* GraphImage::GetStationTrips() const
+{
+    return (const Trip*)section(TripSection);
+}
+
+const GraphImageDeparture* GraphImage::GetDepartures() const
+{
+    return (const GraphImageDeparture*)section(DepartureSection);
+}
+
+const TripPlusLayover* GraphImage::GetEdges() const
+{
+    return (const TripPlusLayover*)section(EdgeSection);
+}
+
+const int* GraphImage::GetLayoverTable() const
+{
+    return (const int*)section(LayoverSection);
+}
+
+const int* GraphImage::GetRideTable() const
+{
+    return (const int*)section(RideSection);
+}
+
+const uint64_t* GraphImage::GetOutLabelOffsets() const
+{
+    return (const uint64_t*)section(OutLabelOffsetSection);
+}
+
+const HubLabelEntry* GraphImage::GetOutLabelEntries() const
+{
+    return (const HubLabelEntry*)section(OutLabelSection);
+}
+
+const uint64_t* GraphImage::GetInLabelOffsets() const
+{
+    return (const uint64_t*)section(InLabelOffsetSection);
+}
+
+const HubLabelEntry* GraphImage::GetInLabelEntries() const
+{
+    return (const HubLabelEntry*)section(InLabelSection);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "trip.hpp"
+#include "hub_label_index.hpp"
+
+class StationGraph;
+
+/*
+    Graph image is a flat, position independent copy of a built StationGraph, including both shortest path
+    sequence tables and the hub label index, so that one builder process can pay for floyd_warshal_shortest_paths and any number of
+    worker processes can map the result read-only. All workers on a host share the same physical pages for the
+    V x V tables, which are the bulk of the graph, and a restarted worker only has to map the file.
+
+    Put the image under /dev/shm for a memory-backed segment, or anywhere on disk to also survive reboots.
+    Images are written to a temporary name and renamed into place, so a worker never maps a half written file.
+
+    Layout is a header followed by 8 byte aligned sections, in order: station records, station names,
+    departing trips, departure records, departure edges, layover table, ride time table, out label offsets, out label
+    entries, in label offsets, in label entries. Arrivals are not stored, the route pattern table built from the
+    departing trips lists them.
+*/
+
+struct GraphImageHeader {
+    char magic[8];
+    int32_t version;
+    int32_t stationCount;
+    int32_t departureCount;
+    int32_t edgeCount;
+    int32_t stationTripCount;
+    int32_t nameBytes;
+    int32_t reserved[2];
+    uint64_t sectionOffsets[11];
+    uint64_t totalBytes;
+};
+
+struct GraphImageStation {
+    int32_t stationID;
+    int32_t nameOffset;
+    int32_t nameLength;
+    int32_t tripOffset;
+    int32_t tripCount;
+};
+
+struct GraphImageDeparture {
+    int32_t stationID;
+    int32_t lookUpKey;
+    int32_t departureTime;
+    int32_t edgeOffset;
+    int32_t edgeCount;
+    // See StationGraph::GetRecordIndex.
+    int32_t recordIndex;
+};
+
+class GraphImage{
+    public:
+        // Write graph and station names to path. Returns false if the file could not be written, graph is a scenario or
+        // its sequence tables and hub labels are not ready yet (see StationGraph::WaitForTables).
+        static bool Write(const std::string& path, const std::vector<std::vector<std::string>>& stationDataTable, const StationGraph& graph);
+        // Map an image read-only. Returns nullptr if the file is missing, truncated or not a graph image.
+        static GraphImage* Map(const std::string& path);
+        ~GraphImage();
+        const GraphImageHeader& GetHeader() const;
+        const GraphImageStation* GetStations() const;
+        std::string GetStationName(int stationIndex) const;
+        const Trip* GetStationTrips() const;
+        const GraphImageDeparture* GetDepartures() const;
+        const TripPlusLayover* GetEdges() const;
+        const int* GetLayoverTable() const;
+        const int* GetRideTable() const;
+        // Packed hub labels, departureCount + 1 offsets per side, see HubLabelIndex.
+        const uint64_t* GetOutLabelOffsets() const;
+        const HubLabelEntry* GetOutLabelEntries() const;
+        const uint64_t* GetInLabelOffsets() const;
+        const HubLabelEntry* GetInLabelEntries() const;
+    private:
+        enum Section { StationSection, NameSection, TripSection, DepartureSection, EdgeSection, LayoverSection, RideSection,
+            OutLabelOffsetSection, OutLabelSection, InLabelOffsetSection, InLabelSection, SectionCount };
+        static const int32_t imageVersion = 4;
+
+        const char* mappedData;
+        size_t mappedBytes;
+
+        GraphImage(const char* data, size_t bytes);
+        const char* section(Section index) const;
+};
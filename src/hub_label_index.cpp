@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include <functional>
+#include "hub_label_index.hpp"
+#include "work_stealing_pool.hpp"
+
+HubLabelIndex::HubLabelIndex(const DepartureBlockList& departureGraph, const std::vector<std::vector<int>>& predecessorTable, int threadCount)
+{
+    vertexCount = departureGraph.size();
+    if(threadCount <= 0)
+    {
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    // Busiest vertices first, they cover the most paths and prune the later searches hardest.
+    std::vector<int> rankOrder(vertexCount);
+    std::iota(rankOrder.begin(), rankOrder.end(), 0);
+    std::stable_sort(rankOrder.begin(), rankOrder.end(), [&](int key1, int key2) {
+        return departureGraph[key1].GetTripCount() + predecessorTable[key1].size() > departureGraph[key2].GetTripCount() + predecessorTable[key2].size();
+    });
+
+    std::vector<std::vector<HubLabelEntry>> outLabels(vertexCount);
+    std::vector<std::vector<HubLabelEntry>> inLabels(vertexCount);
+
+    // The pool's workers outlive the batches. Scratch space is per worker, distances and the hub's own label by rank,
+    // both reset after every search. Found lists are per slot so the batch can be appended in rank order.
+    WorkStealingPool pool(threadCount);
+    std::vector<std::vector<int>> distanceTable(threadCount, std::vector<int>(vertexCount, Utility::INF));
+    std::vector<std::vector<int>> hubLabelTable(threadCount, std::vector<int>(vertexCount, Utility::INF));
+    std::vector<std::vector<std::pair<int, int>>> forwardFound(threadCount);
+    std::vector<std::vector<std::pair<int, int>>> backwardFound(threadCount);
+
+    for(int batchStart = 0; batchStart < vertexCount; batchStart += threadCount)
+    {
+        int batchSize = std::min(threadCount, vertexCount - batchStart);
+
+        pool.ParallelFor(0, batchSize, [&](int slot, int workerIndex) {
+            int hubKey = rankOrder[batchStart + slot];
+            std::vector<int>& hubLabel = hubLabelTable[workerIndex];
+            std::vector<int>& distance = distanceTable[workerIndex];
+
+            for(const HubLabelEntry& entry : outLabels[hubKey]) hubLabel[entry.hubRank] = entry.weight;
+            pruned_search(departureGraph, predecessorTable, hubKey, true, inLabels, hubLabel, distance, forwardFound[slot]);
+            for(const HubLabelEntry& entry : outLabels[hubKey]) hubLabel[entry.hubRank] = Utility::INF;
+
+            for(const HubLabelEntry& entry : inLabels[hubKey]) hubLabel[entry.hubRank] = entry.weight;
+            pruned_search(departureGraph, predecessorTable, hubKey, false, outLabels, hubLabel, distance, backwardFound[slot]);
+            for(const HubLabelEntry& entry : inLabels[hubKey]) hubLabel[entry.hubRank] = Utility::INF;
+        });
+
+        // Appending in rank order keeps every label sorted by hub rank.
+        for(int slot = 0; slot < batchSize; slot++)
+        {
+            int hubRank = batchStart + slot;
+            for(const std::pair<int, int>& vertex : forwardFound[slot])
+            {
+                inLabels[vertex.first].push_back({hubRank, vertex.second});
+            }
+            for(const std::pair<int, int>& vertex : backwardFound[slot])
+            {
+                outLabels[vertex.first].push_back({hubRank, vertex.second});
+            }
+        }
+    }
+
+    pack_labels(outLabels, outLabelOffsetStorage, outLabelEntryStorage);
+    pack_labels(inLabels, inLabelOffsetStorage, inLabelEntryStorage);
+    outLabelOffsets = outLabelOffsetStorage.data();
+    outLabelEntries = outLabelEntryStorage.data();
+    inLabelOffsets = inLabelOffsetStorage.data();
+    inLabelEntries = inLabelEntryStorage.data();
+}
+
+HubLabelIndex::HubLabelIndex(const uint64_t* outOffsets, const HubLabelEntry* outEntries, const uint64_t* inOffsets, const HubLabelEntry* inEntries, int vertexCount)
+    : outLabelOffsets(outOffsets), outLabelEntries(outEntries), inLabelOffsets(inOffsets), inLabelEntries(inEntries), vertexCount(vertexCount)
+{
+}
+
+int HubLabelIndex::edge_weight(const DepartureBlockList& departureGraph, int fromKey, int toKey)
+{
+    return LayoverMetric::Weight(departureGraph[fromKey].FindTripByDestinationKey(toKey));
+}
+
+void HubLabelIndex::pruned_search(const DepartureBlockList& departureGraph, const std::vector<std::vector<int>>& predecessorTable,
+    int hubKey, bool forward, const std::vector<std::vector<HubLabelEntry>>& otherSideLabels, const std::vector<int>& hubLabel,
+    std::vector<int>& distance, std::vector<std::pair<int, int>>& found) const
+{
+    typedef std::pair<int, int> WeightedKey;
+    std::priority_queue<WeightedKey, std::vector<WeightedKey>, std::greater<WeightedKey>> frontier;
+    std::vector<int> touched;
+
+    found.clear();
+    distance[hubKey] = 0;
+    touched.push_back(hubKey);
+    frontier.push({0, hubKey});
+
+    while(!frontier.empty())
+    {
+        WeightedKey current = frontier.top();
+        frontier.pop();
+        if(current.first > distance[current.second])
+        {
+            continue;
+        }
+
+        // Already answered through an earlier hub, nothing past here needs this one.
+        bool covered = false;
+        for(const HubLabelEntry& entry : otherSideLabels[current.second])
+        {
+            if(hubLabel[entry.hubRank] != Utility::INF && hubLabel[entry.hubRank] + entry.weight <= current.first)
+            {
+                covered = true;
+                break;
+            }
+        }
+        if(covered)
+        {
+            continue;
+        }
+
+        found.push_back({current.second, current.first});
+
+        if(forward)
+        {
+            const Departure& departure = departureGraph[current.second];
+            for(int i = 0; i < departure.GetTripCount(); i++)
+            {
+                const TripPlusLayover& trip = departure.GetTrip(i);
+                int newDistance = current.first + LayoverMetric::Weight(trip);
+                if(newDistance < distance[trip.destinationKey])
+                {
+                    if(distance[trip.destinationKey] == Utility::INF) touched.push_back(trip.destinationKey);
+                    distance[trip.destinationKey] = newDistance;
+                    frontier.push({newDistance, trip.destinationKey});
+                }
+            }
+        }
+        else
+        {
+            for(int predecessorKey : predecessorTable[current.second])
+            {
+                int newDistance = current.first + edge_weight(departureGraph, predecessorKey, current.second);
+                if(newDistance < distance[predecessorKey])
+                {
+                    if(distance[predecessorKey] == Utility::INF) touched.push_back(predecessorKey);
+                    distance[predecessorKey] = newDistance;
+                    frontier.push({newDistance, predecessorKey});
+                }
+            }
+        }
+    }
+
+    for(int key : touched)
+    {
+        distance[key] = Utility::INF;
+    }
+}
+
+void HubLabelIndex::pack_labels(std::vector<std::vector<HubLabelEntry>>& labels, std::vector<uint64_t>& offsets, std::vector<HubLabelEntry>& entries)
+{
+    offsets.assign(labels.size() + 1, 0);
+    for(int i = 0; i < labels.size(); i++)
+    {
+        offsets[i + 1] = offsets[i] + labels[i].size();
+    }
+
+    entries.clear();
+    entries.reserve(offsets.back());
+    for(std::vector<HubLabelEntry>& label : labels)
+    {
+        entries.insert(entries.end(), label.begin(), label.end());
+        std::vector<HubLabelEntry>().swap(label);
+    }
+}
+
+int HubLabelIndex::Distance(int fromKey, int toKey) const
+{
+    if(fromKey < 0 || toKey < 0 || fromKey >= vertexCount || toKey >= vertexCount)
+    {
+        return Utility::INF;
+    }
+
+    const HubLabelEntry* out = outLabelEntries + outLabelOffsets[fromKey];
+    const HubLabelEntry* outEnd = outLabelEntries + outLabelOffsets[fromKey + 1];
+    const HubLabelEntry* in = inLabelEntries + inLabelOffsets[toKey];
+    const HubLabelEntry* inEnd = inLabelEntries + inLabelOffsets[toKey + 1];
+
+    int bestWeight = Utility::INF;
+    while(out != outEnd && in != inEnd)
+    {
+        if(out->hubRank < in->hubRank)
+        {
+            ++out;
+        }
+        else if(in->hubRank < out->hubRank)
+        {
+            ++in;
+        }
+        else
+        {
+            bestWeight = std::min(bestWeight, out->weight + in->weight);
+            ++out;
+            ++in;
+        }
+    }
+
+    return bestWeight;
+}
+
+bool HubLabelIndex::Reachable(int fromKey, int toKey) const
+{
+    return Distance(fromKey, toKey) != Utility::INF;
+}
+
+size_t HubLabelIndex::GetLabelEntryCount() const
+{
+    return outLabelOffsets[vertexCount] + inLabelOffsets[vertexCount];
+}
+
+int HubLabelIndex::GetVertexCount() const
+{
+    return vertexCount;
+}
+
+const uint64_t* HubLabelIndex::GetOutLabelOffsets() const
+{
+    return outLabelOffsets;
+}
+
+const HubLabelEntry* HubLabelIndex::GetOutLabelEntries() const
+{
+    return outLabelEntries;
+}
+
+const uint64_t* HubLabelIndex::GetInLabelOffsets() const
+{
+    return inLabelOffsets;
+}
+
+const HubLabelEntry* HubLabelIndex::GetInLabelEntries() const
+{
+    return inLabelEntries;
+}
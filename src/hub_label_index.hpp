@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "utility.hpp"
+#include "departure_block_list.hpp"
+#include "metric_policy.hpp"
+
+/*
+    Hub label index is a 2-hop cover of the departure graph. Every vertex keeps an out label, the hubs it can reach
+    and the weight to each, and an in label, the hubs that can reach it and the weight from each. The minimum weight
+    from u to v is the minimum of out(u)[h] + in(v)[h] over the hubs the two labels share, so a query is one merge of
+    two short sorted lists and no graph walk.
+
+    Labels are built by pruned searches (pruned landmark labeling). Vertices are ranked by degree, and a search from
+    each hub in rank order stops at any vertex the labels built so far already answer correctly. Hubs are searched
+    in batches of threadCount on a work stealing pool, each search pruning against the labels of earlier batches
+    only. That can leave a few redundant entries, never a missing one. Labels are then packed into flat arrays
+    ordered by hub rank.
+
+    Weights use LayoverMetric, so departure time plus the weight to a terminal vertex is the arrival time there.
+
+    Like SequenceTable the packed arrays are either owned (built from a graph) or a read-only view of arrays owned
+    elsewhere, such as a mapped graph image.
+*/
+
+struct HubLabelEntry {
+    int32_t hubRank;
+    int32_t weight;
+};
+
+class HubLabelIndex{
+    public:
+        // predecessorTable holds the reverse edges of departureGraph. threadCount 0 uses one per hardware thread.
+        HubLabelIndex(const DepartureBlockList& departureGraph, const std::vector<std::vector<int>>& predecessorTable, int threadCount = 0);
+        // Read-only view of packed labels owned by the caller, each offsets array has vertexCount + 1 entries.
+        HubLabelIndex(const uint64_t* outOffsets, const HubLabelEntry* outEntries, const uint64_t* inOffsets, const HubLabelEntry* inEntries, int vertexCount);
+        HubLabelIndex(const HubLabelIndex&) = delete;
+        HubLabelIndex& operator=(const HubLabelIndex&) = delete;
+        // Minimum layover-inclusive weight from one departure vertex to another, Utility::INF if there is no path.
+        int Distance(int fromKey, int toKey) const;
+        bool Reachable(int fromKey, int toKey) const;
+        // Total entries over all in and out labels.
+        size_t GetLabelEntryCount() const;
+        int GetVertexCount() const;
+        // Packed labels, see the view constructor.
+        const uint64_t* GetOutLabelOffsets() const;
+        const HubLabelEntry* GetOutLabelEntries() const;
+        const uint64_t* GetInLabelOffsets() const;
+        const HubLabelEntry* GetInLabelEntries() const;
+    private:
+        // Label of vertex k is entries[offsets[k]] up to entries[offsets[k + 1]], sorted by hub rank. The pointers
+        // address the storage vectors unless the index is a view.
+        std::vector<uint64_t> outLabelOffsetStorage;
+        std::vector<HubLabelEntry> outLabelEntryStorage;
+        std::vector<uint64_t> inLabelOffsetStorage;
+        std::vector<HubLabelEntry> inLabelEntryStorage;
+        const uint64_t* outLabelOffsets;
+        const HubLabelEntry* outLabelEntries;
+        const uint64_t* inLabelOffsets;
+        const HubLabelEntry* inLabelEntries;
+        int vertexCount;
+
+        // Search from hubKey over forward edges (filling in labels) or reverse edges (filling out labels). hubLabel
+        // is the hub's own label from the other side spread out by hub rank, found collects the (vertex, weight) pairs
+        // that were not already covered.
+        void pruned_search(const DepartureBlockList& departureGraph, const std::vector<std::vector<int>>& predecessorTable,
+            int hubKey, bool forward, const std::vector<std::vector<HubLabelEntry>>& otherSideLabels, const std::vector<int>& hubLabel,
+            std::vector<int>& distance, std::vector<std::pair<int, int>>& found) const;
+        static int edge_weight(const DepartureBlockList& departureGraph, int fromKey, int toKey);
+        static void pack_labels(std::vector<std::vector<HubLabelEntry>>& labels, std::vector<uint64_t>& offsets, std::vector<HubLabelEntry>& entries);
+};
@@ -0,0 +1,246 @@
+#include "load_generator.hpp"
+
+LoadGenerator::LoadGenerator(std::string queryLogData, StationGraph& graph) : stationGraph(graph)
+{
+    malformedLineCount = 0;
+    errorCount = 0;
+    noRouteCount = 0;
+    elapsedSeconds = 0;
+    requestedQps = 0;
+    coalescedCount = 0;
+    timedOutCount = 0;
+    onDemandCount = 0;
+    queryDeadlineMillis = 0;
+    coalescer = nullptr;
+    dispatchDone = false;
+    build_query_log(queryLogData);
+}
+
+void LoadGenerator::build_query_log(std::string queryLogData)
+{
+    std::stringstream lineStream(queryLogData);
+
+    std::string line;
+    while(getline(lineStream, line))
+    {
+        std::stringstream tokenStream(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while(tokenStream >> token)
+        {
+            tokens.push_back(token);
+        }
+
+        // Blank lines are skipped silently, anything else must be a complete record.
+        if(tokens.size() == 0)
+        {
+            continue;
+        }
+
+        QueryRecord query{-1, -1, QueryMode::Invalid, 0};
+        if(tokens.size() >= 3)
+        {
+            std::stringstream fieldStream(tokens[0] + " " + tokens[1] + " " + (tokens.size() > 3 ? tokens[3] : "0"));
+            fieldStream >> query.departureID >> query.destinationID >> query.twentyFourTime;
+            query.mode = fieldStream.fail() ? QueryMode::Invalid : parse_mode(tokens[2]);
+        }
+
+        if(query.mode == QueryMode::Invalid)
+        {
+            malformedLineCount++;
+        }
+        else
+        {
+            queryLog.push_back(query);
+        }
+    }
+}
+
+QueryMode LoadGenerator::parse_mode(const std::string& token) const
+{
+    if(Utility::CompareStringsNoCase(token, "ride")) return QueryMode::RideTime;
+    if(Utility::CompareStringsNoCase(token, "layover")) return QueryMode::WithLayover;
+    if(Utility::CompareStringsNoCase(token, "time")) return QueryMode::DepartureTime;
+    return QueryMode::Invalid;
+}
+
+int LoadGenerator::GetQueryCount() const
+{
+    return queryLog.size();
+}
+
+Route LoadGenerator::search(const QueryRecord& query, const QueryDeadline* deadline)
+{
+    switch(query.mode)
+    {
+        case QueryMode::RideTime:
+            return stationGraph.GetShortestRoute(query.departureID, query.destinationID, false, deadline);
+        case QueryMode::WithLayover:
+            return stationGraph.GetShortestRoute(query.departureID, query.destinationID, true, deadline);
+        case QueryMode::DepartureTime:
+            return stationGraph.GetRouteFromTime(query.twentyFourTime, query.departureID, query.destinationID, deadline);
+        default:
+            return {{{}, -1, -1, -1}, {}};
+    }
+}
+
+// The deadline starts when a worker picks the query up, so it bounds search time rather than queueing delay.
+Route LoadGenerator::execute_query(const QueryRecord& query)
+{
+    QueryDeadline deadline = queryDeadlineMillis > 0 ? QueryDeadline::AfterMillis(queryDeadlineMillis) : QueryDeadline();
+    const QueryDeadline* deadlinePointer = queryDeadlineMillis > 0 ? &deadline : nullptr;
+    if(!coalescer)
+    {
+        return search(query, deadlinePointer);
+    }
+
+    // Queries that join a search in flight share its deadline along with its result.
+    QueryKey key{query.departureID, query.destinationID, (int)query.mode, query.mode == QueryMode::DepartureTime ? query.twentyFourTime : 0};
+    return coalescer->Execute(key, [this, &query, deadlinePointer] { return search(query, deadlinePointer); });
+}
+
+void LoadGenerator::worker_loop(std::vector<long long>& latencies, int& errors, int& noRoutes, int& timeouts, int& onDemand)
+{
+    while(true)
+    {
+        std::pair<int, Clock::time_point> job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]{ return !pendingQueue.empty() || dispatchDone; });
+            if(pendingQueue.empty())
+            {
+                return;
+            }
+            job = pendingQueue.front();
+            pendingQueue.pop();
+        }
+
+        const QueryRecord& query = queryLog[job.first];
+        if(!stationGraph.GetStationFromGraph(query.departureID).StationIsValid() ||
+            !stationGraph.GetStationFromGraph(query.destinationID).StationIsValid())
+        {
+            errors++;
+        }
+        else
+        {
+            if(!stationGraph.TablesReady())
+            {
+                onDemand++;
+            }
+
+            Route route = execute_query(query);
+            if(route.status == RouteStatus::TimedOut)
+            {
+                timeouts++;
+            }
+            else if(!route.RouteIsValid())
+            {
+                noRoutes++;
+            }
+        }
+
+        // Latency counts from the due time, not from when a worker got to it.
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - job.second).count());
+    }
+}
+
+void LoadGenerator::Run(double targetQps, int workerCount, bool coalesce, int deadlineMillis)
+{
+    queryDeadlineMillis = deadlineMillis;
+    // Each run gets its own coalescer so the count covers this run only.
+    coalescer = coalesce ? new QueryCoalescer() : nullptr;
+
+    latencyTable.clear();
+    errorCount = 0;
+    noRouteCount = 0;
+    timedOutCount = 0;
+    onDemandCount = 0;
+    requestedQps = targetQps;
+    dispatchDone = false;
+
+    if(workerCount < 1)
+    {
+        workerCount = 1;
+    }
+
+    std::vector<std::vector<long long>> workerLatencies(workerCount);
+    std::vector<int> workerErrors(workerCount, 0);
+    std::vector<int> workerNoRoutes(workerCount, 0);
+    std::vector<int> workerTimeouts(workerCount, 0);
+    std::vector<int> workerOnDemand(workerCount, 0);
+    std::vector<std::thread> workers;
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&LoadGenerator::worker_loop, this, std::ref(workerLatencies[i]),
+            std::ref(workerErrors[i]), std::ref(workerNoRoutes[i]), std::ref(workerTimeouts[i]), std::ref(workerOnDemand[i]));
+    }
+
+    // Dispatcher issues each query at its scheduled time whether or not earlier queries have finished.
+    Clock::time_point start = Clock::now();
+    for(int i = 0; i < queryLog.size(); i++)
+    {
+        Clock::time_point due = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(i / targetQps));
+        std::this_thread::sleep_until(due);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pendingQueue.push({i, due});
+        }
+        queueReady.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        dispatchDone = true;
+    }
+    queueReady.notify_all();
+
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers[i].join();
+        latencyTable.insert(latencyTable.end(), workerLatencies[i].begin(), workerLatencies[i].end());
+        errorCount += workerErrors[i];
+        noRouteCount += workerNoRoutes[i];
+        timedOutCount += workerTimeouts[i];
+        onDemandCount += workerOnDemand[i];
+    }
+    elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    coalescedCount = coalescer ? coalescer->GetCoalescedCount() : 0;
+    if(coalescer) delete coalescer;
+    coalescer = nullptr;
+
+    std::sort(latencyTable.begin(), latencyTable.end());
+}
+
+long long LoadGenerator::percentile(double fraction) const
+{
+    if(latencyTable.size() == 0)
+    {
+        return 0;
+    }
+
+    int index = (int)(fraction * (latencyTable.size() - 1) + 0.5);
+    return latencyTable[index];
+}
+
+void LoadGenerator::PrintReport() const
+{
+    double achievedQps = elapsedSeconds > 0 ? latencyTable.size() / elapsedSeconds : 0;
+
+    std::cout << "========================================================================\n"
+    << "REPLAY REPORT\n"
+    << "========================================================================\n"
+    << "Queries replayed:    " << latencyTable.size() << "\n"
+    << "Malformed lines:     " << malformedLineCount << "\n"
+    << "Errors:              " << errorCount << "\n"
+    << "No route found:      " << noRouteCount << "\n"
+    << "Timed out:           " << timedOutCount << "\n"
+    << "Coalesced queries:   " << coalescedCount << "\n"
+    << "Before tables ready: " << onDemandCount << "\n"
+    << "Elapsed:             " << std::fixed << std::setprecision(3) << elapsedSeconds << " s\n"
+    << "Target throughput:   " << std::setprecision(1) << requestedQps << " qps\n"
+    << "Achieved throughput: " << std::setprecision(1) << achievedQps << " qps\n"
+    << "Latency (us):        p50 " << percentile(0.50) << ", p90 " << percentile(0.90)
+    << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999)
+    << ", max " << percentile(1.0) << "\n";
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include "utility.hpp"
+#include "route.hpp"
+#include "station_graph.hpp"
+#include "query_coalescer.hpp"
+
+/*
+    Load generator replays a recorded query log against the in-process StationGraph at a fixed target rate.
+    Arrivals are open-loop: query i is due at start + i / targetQps regardless of how long earlier queries took,
+    and its latency is measured from that due time, so queueing delay is reported instead of hidden when the
+    engine falls behind.
+
+    Query log format is one query per line: <departure id> <destination id> <mode> <HHMM>
+    where mode is "ride" (shortest riding time), "layover" (shortest overall travel time) or "time"
+    (shortest overall travel time leaving at HHMM). The time column is ignored for the first two modes.
+
+    With coalescing on, workers share one search between identical queries that are in flight at the same time, see
+    QueryCoalescer. "time" queries are only identical when their HHMM is, so coalescing never changes a result.
+*/
+
+enum class QueryMode { RideTime, WithLayover, DepartureTime, Invalid };
+
+struct QueryRecord {
+    int departureID;
+    int destinationID;
+    QueryMode mode;
+    int twentyFourTime;
+};
+
+class LoadGenerator{
+    public:
+        LoadGenerator(std::string queryLog, StationGraph& graph);
+        // Replay the whole log once at targetQps using workerCount threads, deadlineMillis 0 lets every query run to
+        // completion.
+        void Run(double targetQps, int workerCount, bool coalesce = false, int deadlineMillis = 0);
+        void PrintReport() const;
+        int GetQueryCount() const;
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        StationGraph& stationGraph;
+        std::vector<QueryRecord> queryLog;
+        int malformedLineCount;
+
+        // Results of the last run, latencies in microseconds.
+        std::vector<long long> latencyTable;
+        int errorCount;
+        int noRouteCount;
+        double elapsedSeconds;
+        double requestedQps;
+        long long coalescedCount;
+        int timedOutCount;
+        // Queries started before the graph's sequence tables were ready, see StationGraph::TablesReady.
+        int onDemandCount;
+        int queryDeadlineMillis;
+        QueryCoalescer* coalescer;
+
+        // Queue of (query index, due time) shared between dispatcher and workers.
+        std::queue<std::pair<int, Clock::time_point>> pendingQueue;
+        std::mutex queueMutex;
+        std::condition_variable queueReady;
+        bool dispatchDone;
+
+        void build_query_log(std::string queryLog);
+        QueryMode parse_mode(const std::string& token) const;
+        Route execute_query(const QueryRecord& query);
+        Route search(const QueryRecord& query, const QueryDeadline* deadline);
+        void worker_loop(std::vector<long long>& latencies, int& errors, int& noRoutes, int& timeouts, int& onDemand);
+        long long percentile(double fraction) const;
+};
@@ -13,23 +13,74 @@ int main(int argc, char** argv)
     std::stringstream stationData;
     std::ifstream trainFile;
     std::stringstream trainData;
+    Schedule* trainSchedule = nullptr;
 
-    if(argc != 3)
+    if(argc == 3 && std::string(argv[1]) == "--image")
     {
-        std::cout << "useage: ./sched.out <stations.dat> <trains.dat>\n";
+        // Attach to a graph image written by a builder process, no precomputation needed.
+        trainSchedule = Schedule::FromGraphImage(argv[2]);
+        if(!trainSchedule)
+        {
+            std::cout << "Could not map graph image " << argv[2] << "\n";
+            return 0;
+        }
+    }
+    else if(argc == 4 && std::string(argv[1]) == "--write-timetable")
+    {
+        // Binary timetables load in place of trains.dat, see timetable_codec.hpp.
+        trainFile.open(argv[2]);
+        trainData << trainFile.rdbuf();
+        trainFile.close();
+
+        int skippedRecords = 0;
+        bool written = Schedule::WriteTimetable(trainData.str(), argv[3], &skippedRecords);
+        if(skippedRecords > 0)
+        {
+            std::cout << "Skipped " << skippedRecords << " malformed frequency records\n";
+        }
+        std::cout << (written ? "Wrote timetable " : "Could not write timetable ") << argv[3] << "\n";
         return 0;
     }
+    else if(argc == 3 || (argc == 5 && std::string(argv[1]) == "--write-image"))
+    {
+        int fileArg = argc == 5 ? 2 : 1;
 
-    // Get file data into a string so schedule can be constructed
-    stationFile.open(argv[1]);
-    stationData << stationFile.rdbuf();
-    stationFile.close();
+        // Get file data into a string so schedule can be constructed
+        stationFile.open(argv[fileArg]);
+        stationData << stationFile.rdbuf();
+        stationFile.close();
 
-    stationFile.open(argv[2]);
-    trainData << stationFile.rdbuf();
-    trainFile.close();
+        stationFile.open(argv[fileArg + 1]);
+        trainData << stationFile.rdbuf();
+        trainFile.close();
 
-    Schedule trainSchedule(stationData.str() , trainData.str());
+        // Interactive sessions start on the on-demand engines while the sequence tables build, writing an image waits for them.
+        trainSchedule = new Schedule(stationData.str() , trainData.str(), argc != 5);
+        if(trainSchedule->TimetableIsCorrupt())
+        {
+            std::cout << "Timetable is corrupt, no trains loaded.\n";
+        }
+        if(trainSchedule->GetSkippedFrequencyRecordCount() > 0)
+        {
+            std::cout << "Skipped " << trainSchedule->GetSkippedFrequencyRecordCount() << " malformed frequency records\n";
+        }
+
+        if(argc == 5)
+        {
+            bool written = trainSchedule->WriteGraphImage(argv[4]);
+            std::cout << (written ? "Wrote graph image " : "Could not write graph image ") << argv[4] << "\n";
+            delete trainSchedule;
+            return 0;
+        }
+    }
+    else
+    {
+        std::cout << "useage: ./sched.out <stations.dat> <trains.dat>\n"
+            << "        ./sched.out --write-image <stations.dat> <trains.dat> <graph image>\n"
+            << "        ./sched.out --image <graph image>\n"
+            << "        ./sched.out --write-timetable <trains.dat> <timetable>\n";
+        return 0;
+    }
 
     Utility::PrintMainMenu();
 
@@ -49,31 +100,43 @@ int main(int argc, char** argv)
         switch (choice)
         {
             case 1:
-                trainSchedule.PrintCompleteSchedule();
+                trainSchedule->PrintCompleteSchedule();
                 break;
             case 2:
-                trainSchedule.PrintStationSchedule();
+                trainSchedule->PrintStationSchedule();
                 break;
             case 3:
-                trainSchedule.LookUpStationId();
+                trainSchedule->LookUpStationId();
                 break;
             case 4:
-                trainSchedule.LookUpStationName();
+                trainSchedule->LookUpStationName();
                 break;
             case 5:
-                trainSchedule.GetRoute();
+                trainSchedule->GetRoute();
                 break;
             case 6:
-                trainSchedule.GetDirectRoute();
+                trainSchedule->GetDirectRoute();
                 break;
             case 7:
-                trainSchedule.ShortestTripLengthRideTime();
+                trainSchedule->ShortestTripLengthRideTime();
                 break;
             case 8:
-                trainSchedule.ShortestTripLengthWithLayover();
+                trainSchedule->ShortestTripLengthWithLayover();
                 break;
             case 9:
-                trainSchedule.ShortestTripDepartureTime();
+                trainSchedule->ShortestTripDepartureTime();
+                break;
+            case 10:
+                trainSchedule->ReachableWithinTime();
+                break;
+            case 11:
+                trainSchedule->LatestTripArrivalTime();
+                break;
+            case 12:
+                trainSchedule->ShortestTripWithConstraints();
+                break;
+            case 13:
+                trainSchedule->ShortestTripBetweenGroups();
                 break;
             case 0:
                 quit = true;
@@ -81,9 +144,10 @@ int main(int argc, char** argv)
                 break;
             default:
                 Utility::PrintMainMenu();
-                std::cout <<"Invalid choice (enter number 0-9).\n";
+                std::cout <<"Invalid choice (enter number 0-13).\n";
                 break;    
         }
     }
 
+    delete trainSchedule;
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include "trip.hpp"
+#include "route.hpp"
+
+/*
+    Metric policies pick which weight a routing kernel minimizes. The kernels in StationGraph are templates
+    over the policy, so each metric gets its own compiled loop and reads its weight directly instead of testing
+    an includeLayovers flag on every edge.
+*/
+
+// Time spent on the train only.
+struct RideTimeMetric {
+    static int Weight(const TripPlusLayover& trip) { return trip.rideTimeToDestinationMins; }
+};
+
+// Time on the train plus time waiting at the station for the next train.
+struct LayoverMetric {
+    static int Weight(const TripPlusLayover& trip) { return trip.tripWeight; }
+};
+
+// Ride plus layover, with a fixed penalty for each change of train. Only transfer edges carry a layover,
+// edges into a terminating vertex always have a layover of 0.
+template<int PenaltyMins>
+struct TransferPenaltyMetric {
+    static int Weight(const TripPlusLayover& trip) { return trip.tripWeight + PenaltyMins * (trip.layoverAtDestinationMins > 0); }
+};
+
+// Total weight of a route under the given metric.
+template<class Metric>
+int RouteWeight(const Route& route)
+{
+    int totalWeight = 0;
+    for(const TripPlusLayover& trip : route.tripList)
+    {
+        totalWeight += Metric::Weight(trip);
+    }
+    return totalWeight;
+}
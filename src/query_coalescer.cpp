@@ -0,0 +1,64 @@
+#include "query_coalescer.hpp"
+
+QueryCoalescer::QueryCoalescer() : searchCount(0), coalescedCount(0)
+{
+}
+
+Route QueryCoalescer::Execute(const QueryKey& key, const std::function<Route()>& search, bool* coalesced)
+{
+    std::promise<Route> result;
+    std::shared_future<Route> pending;
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex);
+        std::map<QueryKey, std::shared_future<Route>>::iterator found = inFlight.find(key);
+        if(found != inFlight.end())
+        {
+            pending = found->second;
+        }
+        else
+        {
+            inFlight[key] = result.get_future().share();
+        }
+    }
+
+    // Wait outside the lock so callers with other keys aren't held up.
+    if(pending.valid())
+    {
+        coalescedCount++;
+        if(coalesced) *coalesced = true;
+        return pending.get();
+    }
+
+    searchCount++;
+    if(coalesced) *coalesced = false;
+
+    try
+    {
+        Route route = search();
+        {
+            std::lock_guard<std::mutex> lock(inFlightMutex);
+            inFlight.erase(key);
+        }
+        result.set_value(route);
+        return route;
+    }
+    catch(...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(inFlightMutex);
+            inFlight.erase(key);
+        }
+        result.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+long long QueryCoalescer::GetSearchCount() const
+{
+    return searchCount;
+}
+
+long long QueryCoalescer::GetCoalescedCount() const
+{
+    return coalescedCount;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <functional>
+#include "route.hpp"
+
+/*
+    In-flight deduplication for concurrent identical queries. The first caller with a key runs the search, callers
+    that arrive with the same key while it is running wait for it and get a copy of the same Route instead of
+    searching again. Nothing is cached: once the search finishes the key is forgotten and the next caller searches
+    afresh, so results never go stale.
+
+    What counts as identical is up to the caller's key, the station pair, the mode and the exact departure time. A
+    search that throws passes the exception to every caller waiting on it.
+*/
+
+struct QueryKey {
+    int departureStationID;
+    int destinationStationID;
+    int mode;
+    // HHMM for queries that leave at a given time, 0 for the rest. Coarser keys would hand one time's route to another.
+    int twentyFourTime;
+
+    bool operator<(const QueryKey& other) const
+    {
+        return std::tie(departureStationID, destinationStationID, mode, twentyFourTime)
+            < std::tie(other.departureStationID, other.destinationStationID, other.mode, other.twentyFourTime);
+    }
+};
+
+class QueryCoalescer{
+    public:
+        QueryCoalescer();
+        // Returns search(), run here or by a concurrent caller with the same key. coalesced, when given, is set if
+        // the result came from another caller's search.
+        Route Execute(const QueryKey& key, const std::function<Route()>& search, bool* coalesced = nullptr);
+        // Searches run, and callers that shared one instead.
+        long long GetSearchCount() const;
+        long long GetCoalescedCount() const;
+    private:
+        std::map<QueryKey, std::shared_future<Route>> inFlight;
+        std::mutex inFlightMutex;
+        std::atomic<long long> searchCount;
+        std::atomic<long long> coalescedCount;
+};
@@ -0,0 +1,28 @@
+#include "query_deadline.hpp"
+
+QueryDeadline::QueryDeadline() : cancelled(std::make_shared<std::atomic<bool>>(false)), hasExpiryTime(false)
+{
+}
+
+QueryDeadline QueryDeadline::AfterMillis(int millis)
+{
+    QueryDeadline deadline;
+    deadline.expiryTime = Clock::now() + std::chrono::milliseconds(millis);
+    deadline.hasExpiryTime = true;
+    return deadline;
+}
+
+void QueryDeadline::Cancel() const
+{
+    *cancelled = true;
+}
+
+bool QueryDeadline::Expired() const
+{
+    return *cancelled || (hasExpiryTime && Clock::now() >= expiryTime);
+}
+
+// A deadline that has already passed is noticed on the first check rather than after CheckInterval units.
+DeadlineMonitor::DeadlineMonitor(const QueryDeadline* deadline) : deadline(deadline), workSinceCheck(CheckInterval), expired(false)
+{
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+/*
+    Deadline and cancellation token for routing queries. A search given a deadline checks it as it goes and gives up
+    with RouteStatus::TimedOut once the time has passed or the token was cancelled. Copies share the cancellation
+    flag, so a caller can hand a copy to the query and cancel it from another thread.
+
+    Searches don't read the clock on every step, they count work with a DeadlineMonitor and only look at the
+    deadline every DeadlineMonitor::CheckInterval units.
+*/
+
+class QueryDeadline{
+    public:
+        // Never expires, unless cancelled.
+        QueryDeadline();
+        static QueryDeadline AfterMillis(int millis);
+        // Cancels this deadline and every copy of it.
+        void Cancel() const;
+        bool Expired() const;
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        Clock::time_point expiryTime;
+        bool hasExpiryTime;
+};
+
+// Per search view of a deadline, nullptr never expires. Once expired it stays expired.
+class DeadlineMonitor{
+    public:
+        static const int CheckInterval = 4096;
+        DeadlineMonitor(const QueryDeadline* deadline);
+        // Records work units done since the last call, true once the deadline has passed.
+        bool Expired(int work = 1)
+        {
+            if(!deadline)
+            {
+                return false;
+            }
+            workSinceCheck += work;
+            if(workSinceCheck >= CheckInterval && !expired)
+            {
+                workSinceCheck = 0;
+                expired = deadline->Expired();
+            }
+            return expired;
+        }
+    private:
+        const QueryDeadline* deadline;
+        int workSinceCheck;
+        bool expired;
+};
@@ -0,0 +1,320 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include "schedule.hpp"
+
+/*
+    Regression checks for the parts of the library whose answers can be derived another way:
+
+        scenarios   cancelling trains in a forked scenario answers every query like a schedule built from trains.dat
+                    without those lines, and leaves the schedule it was forked from as it was
+        closures    GetClosureImpacts agrees with closing each station or train through RouteConstraints and
+                    searching every pair again, and is sorted most disruptive first
+        background  a schedule building its tables in the background answers like one built synchronously, both
+                    before and after the tables are ready
+
+    Prints one line per check and exits with 1 if any of them failed, or on a usage error. With --random the network
+    is generated from a seed instead of read from files, see make check.
+*/
+
+bool read_file(const char* path, std::string& contents)
+{
+    std::ifstream inFile(path);
+    if(!inFile.is_open()) return false;
+    std::stringstream fileData;
+    fileData << inFile.rdbuf();
+    contents = fileData.str();
+    return true;
+}
+
+// stations.dat and trains.dat for stationCount stations and trainCount trains at random times, each ride 5 to 180
+// minutes and ending by 2359.
+void generate_network(int stationCount, int trainCount, int seed, std::string& stationData, std::string& trainsData)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> station(1, stationCount);
+    std::uniform_int_distribution<int> departureMinute(0, 22 * 60 - 1);
+    std::uniform_int_distribution<int> rideMins(5, 180);
+
+    std::stringstream stations;
+    for(int stationID = 1; stationID <= stationCount; stationID++) stations << stationID << " station_" << stationID << "\n";
+    stationData = stations.str();
+
+    std::stringstream trains;
+    trains << std::setfill('0');
+    for(int i = 0; i < trainCount; i++)
+    {
+        int departureID = station(generator);
+        int destinationID = station(generator);
+        while(destinationID == departureID) destinationID = station(generator);
+        int departureTime = departureMinute(generator);
+        int arrivalTime = std::min(departureTime + rideMins(generator), 23 * 60 + 59);
+        trains << departureID << " " << destinationID << " " << std::setw(2) << departureTime / 60 << std::setw(2) << departureTime % 60
+            << " " << std::setw(2) << arrivalTime / 60 << std::setw(2) << arrivalTime % 60 << "\n";
+    }
+    trainsData = trains.str();
+}
+
+int route_weight(Route tripRoute, bool includeLayovers)
+{
+    if(!tripRoute.RouteIsValid()) return -1;
+    return includeLayovers ? RouteWeight<LayoverMetric>(tripRoute) : RouteWeight<RideTimeMetric>(tripRoute);
+}
+
+// Every query a scenario answers, one line per station pair plus the earliest arrivals and the travel time matrix.
+std::vector<std::string> query_results(StationGraph& graph, const std::vector<int>& departureTimes)
+{
+    int stationCount = graph.GetVertexCount();
+    std::vector<std::string> results;
+    for(int departureID = 1; departureID <= stationCount; departureID++)
+    {
+        for(int destinationID = 1; destinationID <= stationCount; destinationID++)
+        {
+            std::stringstream result;
+            result << departureID << " " << destinationID << " " << graph.PathExists(departureID, destinationID)
+                << graph.DirectPathExists(departureID, destinationID)
+                << " " << route_weight(graph.GetShortestRoute(departureID, destinationID, false), false)
+                << " " << route_weight(graph.GetShortestRoute(departureID, destinationID, true), true);
+            for(int departureTime : departureTimes)
+            {
+                result << " " << route_weight(graph.GetRouteFromTime(departureTime, departureID, destinationID), true);
+            }
+            Route latestRoute = graph.GetLatestDepartureRoute(1800, departureID, destinationID);
+            result << " " << (latestRoute.RouteIsValid() ? latestRoute.departingStation.GetDepartureTime() : -1);
+            results.push_back(result.str());
+        }
+        for(int departureTime : departureTimes)
+        {
+            std::stringstream result;
+            result << departureID << " at " << departureTime << ":";
+            for(int arrival : graph.GetEarliestArrivals(departureID, departureTime)) result << " " << arrival;
+            results.push_back(result.str());
+        }
+    }
+
+    std::vector<int> stationIDs;
+    for(int stationID = 1; stationID <= stationCount; stationID++) stationIDs.push_back(stationID);
+    std::stringstream matrix;
+    for(int weight : graph.GetTravelTimeMatrix(stationIDs, stationIDs, true, 2)) matrix << weight << " ";
+    results.push_back(matrix.str());
+    return results;
+}
+
+int count_differences(const std::vector<std::string>& expected, const std::vector<std::string>& actual)
+{
+    int differences = expected.size() > actual.size() ? expected.size() - actual.size() : actual.size() - expected.size();
+    for(int i = 0; i < expected.size() && i < actual.size(); i++)
+    {
+        if(expected[i] != actual[i]) differences++;
+    }
+    return differences;
+}
+
+// Cancels every trainStep'th train in a scenario and compares it with a schedule built without those trains.
+bool check_scenarios(const std::string& stationData, const std::string& trainsData)
+{
+    std::vector<std::string> lines;
+    std::vector<std::vector<int>> trains;
+    std::stringstream trainLines(trainsData);
+    std::string line;
+    while(std::getline(trainLines, line))
+    {
+        std::stringstream fields(line);
+        std::vector<int> train(3);
+        lines.push_back(line);
+        if(!(fields >> train[0] >> train[1] >> train[2])) train.clear();
+        trains.push_back(train);
+    }
+
+    // Four departure times spread over the day the trains run.
+    std::vector<int> trainTimes;
+    for(const std::vector<int>& train : trains)
+    {
+        if(!train.empty()) trainTimes.push_back(train[2]);
+    }
+    std::sort(trainTimes.begin(), trainTimes.end());
+    std::vector<int> departureTimes;
+    for(int i = 0; i < 4 && !trainTimes.empty(); i++) departureTimes.push_back(trainTimes[i * trainTimes.size() / 4]);
+
+    // Trains that share a station, time and next station can't be told apart by CancelTrain, leave them running.
+    std::vector<char> cancelled(lines.size(), 0);
+    int trainStep = std::max<int>(1, lines.size() / 8);
+    int cancelCount = 0;
+    for(int i = trainStep / 2; i < lines.size(); i += trainStep)
+    {
+        if(trains[i].empty() || std::count(trains.begin(), trains.end(), trains[i]) > 1) continue;
+        cancelled[i] = 1;
+        cancelCount++;
+    }
+
+    Schedule baseSchedule(stationData, trainsData);
+    std::vector<std::string> baseResults = query_results(baseSchedule.GetStationGraph(), departureTimes);
+
+    Schedule* scenario = baseSchedule.ForkScenario();
+    bool cancelFailed = false;
+    std::string remainingTrains;
+    for(int i = 0; i < lines.size(); i++)
+    {
+        if(!cancelled[i])
+        {
+            remainingTrains += lines[i] + "\n";
+        }
+        else if(!scenario->CancelTrain(trains[i][0], trains[i][2], trains[i][1]))
+        {
+            cancelFailed = true;
+        }
+    }
+    bool baseRefused = true;
+    for(int i = 0; i < trains.size() && baseRefused; i++)
+    {
+        if(!trains[i].empty()) baseRefused = !baseSchedule.CancelTrain(trains[i][0], trains[i][2], trains[i][1]);
+    }
+
+    Schedule rebuiltSchedule(stationData, remainingTrains);
+    int differences = count_differences(query_results(rebuiltSchedule.GetStationGraph(), departureTimes),
+        query_results(scenario->GetStationGraph(), departureTimes));
+    delete scenario;
+    int baseDifferences = count_differences(baseResults, query_results(baseSchedule.GetStationGraph(), departureTimes));
+
+    bool passed = !cancelFailed && baseRefused && differences == 0 && baseDifferences == 0;
+    std::cout << (passed ? "ok  " : "FAIL") << " scenarios: " << cancelCount << " trains cancelled, " << differences
+        << " results differ from the rebuilt schedule, " << baseDifferences << " from the base schedule"
+        << (cancelFailed ? ", a cancellation failed" : "") << (baseRefused ? "" : ", the base schedule took a cancellation") << "\n";
+    return passed;
+}
+
+// Searches every pair again for up to closureLimit closures (0 for all) of each kind.
+bool check_closures(const std::string& stationData, const std::string& trainsData, int closureLimit)
+{
+    Schedule trainSchedule(stationData, trainsData);
+    StationGraph& graph = trainSchedule.GetStationGraph();
+    int stationCount = graph.GetVertexCount();
+
+    RouteConstraints noConstraints;
+    std::vector<std::vector<int>> baseWeights(stationCount + 1, std::vector<int>(stationCount + 1));
+    for(int departureID = 1; departureID <= stationCount; departureID++)
+    {
+        for(int destinationID = 1; destinationID <= stationCount; destinationID++)
+        {
+            baseWeights[departureID][destinationID] = route_weight(graph.GetConstrainedRoute(departureID, destinationID, noConstraints, true), true);
+        }
+    }
+
+    int checkedCount = 0;
+    int mismatchCount = 0;
+    int unsortedCount = 0;
+    for(int closeTrips = 0; closeTrips < 2; closeTrips++)
+    {
+        std::vector<ClosureImpact> impacts = graph.GetClosureImpacts(closeTrips, 0);
+        for(int i = 1; i < impacts.size(); i++)
+        {
+            if(impacts[i - 1].disconnectedPairs < impacts[i].disconnectedPairs) unsortedCount++;
+        }
+
+        for(int i = 0; i < impacts.size() && (closureLimit <= 0 || i < closureLimit); i++)
+        {
+            const ClosureImpact& impact = impacts[i];
+            RouteConstraints closure;
+            if(impact.stationID > 0) closure.AvoidStation(impact.stationID);
+            else closure.AvoidTrip(impact.departureKey);
+
+            int disconnectedPairs = 0;
+            long long addedMinutes = 0;
+            for(int departureID = 1; departureID <= stationCount; departureID++)
+            {
+                for(int destinationID = 1; destinationID <= stationCount; destinationID++)
+                {
+                    int baseWeight = baseWeights[departureID][destinationID];
+                    if(departureID == destinationID || baseWeight < 0) continue;
+                    if(departureID == impact.stationID || destinationID == impact.stationID) continue;
+
+                    int weight = route_weight(graph.GetConstrainedRoute(departureID, destinationID, closure, true), true);
+                    if(weight < 0) disconnectedPairs++;
+                    else addedMinutes += weight - baseWeight;
+                }
+            }
+
+            checkedCount++;
+            if(disconnectedPairs != impact.disconnectedPairs || addedMinutes != impact.addedMinutes) mismatchCount++;
+        }
+    }
+
+    bool passed = mismatchCount == 0 && unsortedCount == 0;
+    std::cout << (passed ? "ok  " : "FAIL") << " closures: " << checkedCount << " closures searched again, "
+        << mismatchCount << " differ, " << unsortedCount << " out of order\n";
+    return passed;
+}
+
+bool check_background_build(const std::string& stationData, const std::string& trainsData)
+{
+    Schedule builtSchedule(stationData, trainsData);
+    Schedule backgroundSchedule(stationData, trainsData, true);
+    StationGraph& builtGraph = builtSchedule.GetStationGraph();
+    StationGraph& backgroundGraph = backgroundSchedule.GetStationGraph();
+    int stationCount = builtGraph.GetVertexCount();
+
+    int earlyCount = 0;
+    int differences = 0;
+    for(int pass = 0; pass < 2; pass++)
+    {
+        if(pass == 1) backgroundGraph.WaitForTables();
+        for(int departureID = 1; departureID <= stationCount; departureID++)
+        {
+            for(int destinationID = 1; destinationID <= stationCount; destinationID++)
+            {
+                bool tablesReady = backgroundGraph.TablesReady();
+                for(int includeLayovers = 0; includeLayovers < 2; includeLayovers++)
+                {
+                    if(route_weight(backgroundGraph.GetShortestRoute(departureID, destinationID, includeLayovers), includeLayovers)
+                        != route_weight(builtGraph.GetShortestRoute(departureID, destinationID, includeLayovers), includeLayovers))
+                    {
+                        differences++;
+                    }
+                }
+                if(backgroundGraph.PathExists(departureID, destinationID) != builtGraph.PathExists(departureID, destinationID)) differences++;
+                if(!tablesReady) earlyCount++;
+            }
+        }
+    }
+
+    bool passed = builtGraph.TablesReady() && backgroundGraph.TablesReady() && differences == 0;
+    std::cout << (passed ? "ok  " : "FAIL") << " background build: " << earlyCount << " of " << 2 * stationCount * stationCount
+        << " station pairs queried before the tables were ready, " << differences << " differ from the built schedule\n";
+    return passed;
+}
+
+int main(int argc, char** argv)
+{
+    bool generated = argc >= 2 && std::string(argv[1]) == "--random";
+    int argCount = generated ? 5 : 3;
+    if(argc < argCount || argc > argCount + 1 || (generated && (atoi(argv[2]) < 2 || atoi(argv[3]) < 1)))
+    {
+        std::cout << "useage: ./regression.out <stations.dat> <trains.dat> [closures to check, 0 for all]\n"
+            << "        ./regression.out --random <stations> <trains> <seed> [closures to check, 0 for all]\n";
+        return 1;
+    }
+
+    std::string stationData;
+    std::string trainsData;
+    if(generated)
+    {
+        generate_network(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), stationData, trainsData);
+    }
+    else if(!read_file(argv[1], stationData) || !read_file(argv[2], trainsData))
+    {
+        std::cout << "Could not read " << argv[1] << " or " << argv[2] << "\n";
+        return 1;
+    }
+    int closureLimit = argc == argCount + 1 ? atoi(argv[argCount]) : 20;
+
+    bool passed = check_scenarios(stationData, trainsData);
+    passed = check_closures(stationData, trainsData, closureLimit) && passed;
+    passed = check_background_build(stationData, trainsData) && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <chrono>
+#include "schedule.hpp"
+#include "load_generator.hpp"
+
+int main(int argc, char** argv)
+{
+    if(argc < 5 || argc > 9)
+    {
+        std::cout << "useage: ./replay.out <stations.dat> <trains.dat> <queries.dat> <target qps> [worker threads] [coalesce 0|1] [deadline ms]\n"
+            << "        [background tables 0|1]\n";
+        return 0;
+    }
+
+    std::ifstream inFile;
+    std::stringstream stationData;
+    std::stringstream trainData;
+    std::stringstream queryData;
+
+    inFile.open(argv[1]);
+    stationData << inFile.rdbuf();
+    inFile.close();
+
+    inFile.open(argv[2]);
+    trainData << inFile.rdbuf();
+    inFile.close();
+
+    inFile.open(argv[3]);
+    queryData << inFile.rdbuf();
+    inFile.close();
+
+    double targetQps = atof(argv[4]);
+    int workerCount = argc >= 6 ? atoi(argv[5]) : 1;
+    bool coalesce = argc >= 7 && atoi(argv[6]) != 0;
+    int deadlineMillis = argc >= 8 ? atoi(argv[7]) : 0;
+    bool backgroundTables = argc == 9 && atoi(argv[8]) != 0;
+    if(targetQps <= 0)
+    {
+        std::cout << "Target qps must be greater than 0.\n";
+        return 0;
+    }
+
+    // With background tables replay starts as soon as the departure graph is built, the way a freshly deployed
+    // service would, and the early queries run on the on-demand engines.
+    std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+    Schedule trainSchedule(stationData.str(), trainData.str(), backgroundTables);
+    std::cout << "Queryable after " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count()
+        << " ms\n";
+    LoadGenerator generator(queryData.str(), trainSchedule.GetStationGraph());
+
+    std::cout << "Replaying " << generator.GetQueryCount() << " queries at " << targetQps
+        << " qps with " << workerCount << " worker(s)" << (coalesce ? ", coalescing" : "") << "...\n";
+    generator.Run(targetQps, workerCount, coalesce, deadlineMillis);
+    generator.PrintReport();
+}
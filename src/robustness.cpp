@@ -0,0 +1,122 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include "schedule.hpp"
+
+// Train as "from -> to at HHMM".
+std::string describe_departure(Schedule& trainSchedule, int departureKey)
+{
+    StationGraph& graph = trainSchedule.GetStationGraph();
+    Departure departure = graph.GetDepartureFromGraph(departureKey);
+    int nextStationID = graph.GetDepartureFromGraph(departure.GetTrip(0).destinationKey).GetStationID();
+
+    std::stringstream description;
+    description << trainSchedule.SimpleStationNameLookup(departure.GetStationID()) << " -> "
+        << trainSchedule.SimpleStationNameLookup(nextStationID) << " at "
+        << std::setw(4) << std::setfill('0') << departure.GetDepartureTime();
+    return description.str();
+}
+
+// Busiest stations and trains by share of shortest journeys, see StationGraph::GetBetweenness.
+void print_load_table(Schedule& trainSchedule, const BetweennessScores& scores, int rowLimit)
+{
+    std::vector<int> stationOrder(scores.stationScores.size());
+    std::vector<int> departureOrder(scores.departureScores.size());
+    for(int i = 0; i < stationOrder.size(); i++) stationOrder[i] = i;
+    for(int i = 0; i < departureOrder.size(); i++) departureOrder[i] = i;
+    std::stable_sort(stationOrder.begin(), stationOrder.end(), [&scores](int i, int j) { return scores.stationScores[i] > scores.stationScores[j]; });
+    std::stable_sort(departureOrder.begin(), departureOrder.end(), [&scores](int i, int j) { return scores.departureScores[i] > scores.departureScores[j]; });
+
+    std::cout << scores.journeyCount << " journeys from departures to stations.\n";
+    std::cout << std::left << std::setw(6) << "Rank" << std::setw(40) << "Station" << std::right << std::setw(14) << "Journeys" << "\n";
+    for(int i = 0; i < stationOrder.size() && (rowLimit <= 0 || i < rowLimit); i++)
+    {
+        std::string station = std::to_string(stationOrder[i] + 1) + " " + trainSchedule.SimpleStationNameLookup(stationOrder[i] + 1);
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(40) << station.substr(0, 39)
+            << std::right << std::setw(14) << std::fixed << std::setprecision(2) << scores.stationScores[stationOrder[i]] << "\n";
+    }
+
+    std::cout << std::left << std::setw(6) << "Rank" << std::setw(40) << "Train" << std::right << std::setw(14) << "Journeys" << "\n";
+    for(int i = 0; i < departureOrder.size() && (rowLimit <= 0 || i < rowLimit) && scores.departureScores[departureOrder[i]] > 0; i++)
+    {
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(40) << describe_departure(trainSchedule, departureOrder[i]).substr(0, 39)
+            << std::right << std::setw(14) << std::fixed << std::setprecision(2) << scores.departureScores[departureOrder[i]] << "\n";
+    }
+}
+
+void print_pool_metrics(const PoolMetrics& metrics)
+{
+    double utilisation = metrics.elapsedSeconds > 0 ? 100 * metrics.busySeconds / (metrics.elapsedSeconds * metrics.threadCount) : 0;
+    std::cout << "Ran " << metrics.tasksRun << " tasks (" << metrics.tasksStolen << " stolen, " << metrics.tasksSplit << " split) on "
+        << metrics.threadCount << " threads in " << std::fixed << std::setprecision(3) << metrics.elapsedSeconds << "s, "
+        << std::setprecision(1) << utilisation << "% busy.\n";
+}
+
+int main(int argc, char** argv)
+{
+    std::string mode = argc >= 4 ? argv[3] : "stations";
+    bool closeTrips = mode == "trips";
+    if(argc < 3 || argc > 6 || (mode != "stations" && mode != "trips" && mode != "load"))
+    {
+        std::cout << "useage: ./robustness.out <stations.dat> <trains.dat> [stations|trips|load] [threads] [top N]\n";
+        return 0;
+    }
+
+    std::ifstream inFile;
+    std::stringstream stationData;
+    std::stringstream trainData;
+
+    inFile.open(argv[1]);
+    stationData << inFile.rdbuf();
+    inFile.close();
+
+    inFile.open(argv[2]);
+    trainData << inFile.rdbuf();
+    inFile.close();
+
+    int threadCount = argc >= 5 ? atoi(argv[4]) : 0;
+    int rowLimit = argc == 6 ? atoi(argv[5]) : 20;
+
+    Schedule trainSchedule(stationData.str(), trainData.str());
+    StationGraph& graph = trainSchedule.GetStationGraph();
+
+    if(mode == "load")
+    {
+        PoolMetrics metrics;
+        print_load_table(trainSchedule, graph.GetBetweenness(threadCount, &metrics), rowLimit);
+        print_pool_metrics(metrics);
+        return 0;
+    }
+
+    PoolMetrics metrics;
+    std::vector<ClosureImpact> impacts = graph.GetClosureImpacts(closeTrips, threadCount, &metrics);
+
+    std::cout << "Closing each " << (closeTrips ? "train" : "station") << " in turn, " << impacts.size()
+        << " closures, most disruptive first:\n";
+    std::cout << std::left << std::setw(6) << "Rank" << std::setw(40) << (closeTrips ? "Train" : "Station")
+        << std::right << std::setw(14) << "Disconnected" << std::setw(14) << "Added mins" << std::setw(12) << "Searched" << "\n";
+
+    for(int i = 0; i < impacts.size() && (rowLimit <= 0 || i < rowLimit); i++)
+    {
+        const ClosureImpact& impact = impacts[i];
+        std::stringstream closure;
+        if(impact.stationID > 0)
+        {
+            closure << impact.stationID << " " << trainSchedule.SimpleStationNameLookup(impact.stationID);
+        }
+        else
+        {
+            closure << describe_departure(trainSchedule, impact.departureKey);
+        }
+
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(40) << closure.str().substr(0, 39)
+            << std::right << std::setw(14) << impact.disconnectedPairs << std::setw(14) << impact.addedMinutes
+            << std::setw(12) << impact.recomputedOrigins << "\n";
+    }
+
+    print_pool_metrics(metrics);
+}
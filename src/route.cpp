@@ -0,0 +1,14 @@
+#include "route.hpp"
+
+bool Route::RouteIsValid()
+{
+    if(tripList.size() > 0 && departingStation.GetTripCount() > 0)
+    {
+        return true;
+    }         
+    else
+    {
+        return false;
+    }
+    
+}
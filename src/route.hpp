@@ -3,21 +3,13 @@
 #include "departure.hpp"
 #include "trip.hpp"
 
+// TimedOut routes are invalid, the query's deadline passed or it was cancelled before the search finished.
+// Unproven routes are valid, the best an anytime query found before its deadline, but a better one may exist.
+enum class RouteStatus { Complete, TimedOut, Unproven };
+
 struct Route {
     bool RouteIsValid();
     Departure departingStation;
     std::vector<TripPlusLayover> tripList;
+    RouteStatus status = RouteStatus::Complete;
 };
-
-bool Route::RouteIsValid()
-{
-    if(tripList.size() > 0 && departingStation.GetTripCount() > 0)
-    {
-        return true;
-    }         
-    else
-    {
-        return false;
-    }
-    
-}
\ No newline at end of file
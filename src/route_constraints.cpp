@@ -0,0 +1,42 @@
+#include "route_constraints.hpp"
+
+void RouteConstraints::AddViaStation(int stationID)
+{
+    viaStationIDs.push_back(stationID);
+}
+
+void RouteConstraints::AvoidStation(int stationID)
+{
+    if(stationID < 1)
+    {
+        return;
+    }
+    if(avoidedStations.size() < stationID)
+    {
+        avoidedStations.resize(stationID, 0);
+    }
+    avoidedStations[stationID - 1] = 1;
+}
+
+void RouteConstraints::AvoidTrip(int departureKey)
+{
+    if(departureKey < 0)
+    {
+        return;
+    }
+    if(avoidedTrips.size() <= departureKey)
+    {
+        avoidedTrips.resize(departureKey + 1, 0);
+    }
+    avoidedTrips[departureKey] = 1;
+}
+
+bool RouteConstraints::StationAvoided(int stationID) const
+{
+    return stationID >= 1 && stationID <= avoidedStations.size() && avoidedStations[stationID - 1];
+}
+
+bool RouteConstraints::TripAvoided(int departureKey) const
+{
+    return departureKey >= 0 && departureKey < avoidedTrips.size() && avoidedTrips[departureKey];
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+/*
+    Per-query routing constraints for the on-demand engines. Via stations are visited in order by chaining one search
+    per leg, avoided stations and trips are masks the search consults before using a vertex, so nothing in the
+    precomputed graph has to be rebuilt. A default constructed RouteConstraints constrains nothing.
+*/
+
+struct RouteConstraints {
+    // Stations the route must change trains at (or end at), in the order given.
+    std::vector<int> viaStationIDs;
+    // Indexed by station id - 1 and by departure key. Only as long as the highest entry set.
+    std::vector<char> avoidedStations;
+    std::vector<char> avoidedTrips;
+
+    void AddViaStation(int stationID);
+    void AvoidStation(int stationID);
+    // departureKey as returned by StationGraph::FindDepartureKey.
+    void AvoidTrip(int departureKey);
+    bool StationAvoided(int stationID) const;
+    bool TripAvoided(int departureKey) const;
+};
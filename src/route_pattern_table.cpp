@@ -0,0 +1,276 @@
+#include <algorithm>
+#include "route_pattern_table.hpp"
+
+RoutePatternTable::RoutePatternTable(std::vector<std::vector<Trip>> stationTrips) : stationCount(stationTrips.size())
+{
+    build_patterns(stationTrips);
+    build_services({});
+}
+
+RoutePatternTable::RoutePatternTable(const std::vector<std::vector<std::string>>& tripDataTable, int stationsCount,
+    const std::vector<FrequencyService>& services) : stationCount(stationsCount)
+{
+    std::vector<std::vector<Trip>> stationTrips(stationCount);
+    for(int i = 0; i < tripDataTable.size(); i++)
+    {
+        stationTrips[stoi(tripDataTable[i][0]) - 1].push_back({stoi(tripDataTable[i][1]), stoi(tripDataTable[i][2]), stoi(tripDataTable[i][3])});
+    }
+
+    build_patterns(stationTrips);
+    build_services(services);
+}
+
+void RoutePatternTable::build_patterns(std::vector<std::vector<Trip>>& stationTrips)
+{
+    stationPatternStart.push_back(0);
+    for(int stationIndex = 0; stationIndex < stationCount; stationIndex++)
+    {
+        std::vector<Trip>& trips = stationTrips[stationIndex];
+        std::sort(trips.begin(), trips.end(), [](const Trip& a, const Trip& b) {
+            return a.destinationID < b.destinationID || (a.destinationID == b.destinationID && a.departureTime < b.departureTime);
+        });
+
+        for(int i = 0; i < trips.size(); i++)
+        {
+            if(i == 0 || trips[i].destinationID != trips[i - 1].destinationID)
+            {
+                patternDepartureStation.push_back(stationIndex + 1);
+                patternDestinationStation.push_back(trips[i].destinationID);
+                patternRowStart.push_back(departureTimes.size());
+            }
+            departureTimes.push_back(trips[i].departureTime);
+            arrivalTimes.push_back(trips[i].arrivalTime);
+        }
+        stationPatternStart.push_back(patternDepartureStation.size());
+    }
+    patternRowStart.push_back(departureTimes.size());
+
+    build_arrival_index(GetPatternCount(), [this](int pattern) { return patternDestinationStation[pattern]; },
+        arrivalPatterns, arrivalPatternStart);
+
+    earliestArrivalFromRow = arrivalTimes;
+    for(int pattern = 0; pattern < GetPatternCount(); pattern++)
+    {
+        for(int row = patternRowStart[pattern + 1] - 2; row >= patternRowStart[pattern]; row--)
+        {
+            earliestArrivalFromRow[row] = std::min(earliestArrivalFromRow[row], earliestArrivalFromRow[row + 1]);
+        }
+    }
+}
+
+void RoutePatternTable::build_services(const std::vector<FrequencyService>& services)
+{
+    frequencyServices = services;
+    std::stable_sort(frequencyServices.begin(), frequencyServices.end(), [](const FrequencyService& a, const FrequencyService& b) {
+        return a.departureStationID < b.departureStationID;
+    });
+
+    stationServiceStart.assign(stationCount + 1, 0);
+    for(const FrequencyService& service : frequencyServices)
+    {
+        stationServiceStart[service.departureStationID]++;
+    }
+    for(int i = 0; i < stationCount; i++)
+    {
+        stationServiceStart[i + 1] += stationServiceStart[i];
+    }
+
+    build_arrival_index(frequencyServices.size(), [this](int service) { return frequencyServices[service].destinationStationID; },
+        arrivalServices, arrivalServiceStart);
+}
+
+template<class DestinationOf>
+void RoutePatternTable::build_arrival_index(int count, DestinationOf destinationOf, std::vector<int>& order, std::vector<int>& start) const
+{
+    start.assign(stationCount + 1, 0);
+    for(int i = 0; i < count; i++)
+    {
+        start[destinationOf(i)]++;
+    }
+    for(int i = 0; i < stationCount; i++)
+    {
+        start[i + 1] += start[i];
+    }
+
+    // Fill each station's range back to front so ties stay in index order.
+    order.resize(count);
+    std::vector<int> next(start.begin() + 1, start.end());
+    for(int i = count - 1; i >= 0; i--)
+    {
+        order[--next[destinationOf(i) - 1]] = i;
+    }
+}
+
+void RoutePatternTable::append_runs(const FrequencyService& service, std::vector<Trip>& trips)
+{
+    int departureMins = Utility::TwentyFourTimeToMinutes(service.firstDepartureTime);
+    for(int run = 0; run < service.GetRunCount(); run++, departureMins += service.headwayMins)
+    {
+        trips.push_back({service.destinationStationID, Utility::MinutesToTwentyFourTime(departureMins),
+            Utility::MinutesToTwentyFourTime(departureMins + service.rideMins)});
+    }
+}
+
+std::vector<Trip> RoutePatternTable::StationDepartures(int stationID) const
+{
+    std::vector<Trip> trips;
+    if(stationID < 1 || stationID > stationCount)
+    {
+        return trips;
+    }
+
+    for(int pattern = stationPatternStart[stationID - 1]; pattern < stationPatternStart[stationID]; pattern++)
+    {
+        for(int row = patternRowStart[pattern]; row < patternRowStart[pattern + 1]; row++)
+        {
+            trips.push_back({patternDestinationStation[pattern], departureTimes[row], arrivalTimes[row]});
+        }
+    }
+    for(int service = stationServiceStart[stationID - 1]; service < stationServiceStart[stationID]; service++)
+    {
+        append_runs(frequencyServices[service], trips);
+    }
+
+    std::stable_sort(trips.begin(), trips.end(), [](const Trip& a, const Trip& b) { return a.departureTime < b.departureTime; });
+    return trips;
+}
+
+std::vector<Trip> RoutePatternTable::StationArrivals(int stationID) const
+{
+    std::vector<Trip> trips;
+    if(stationID < 1 || stationID > stationCount)
+    {
+        return trips;
+    }
+
+    for(int i = arrivalPatternStart[stationID - 1]; i < arrivalPatternStart[stationID]; i++)
+    {
+        int pattern = arrivalPatterns[i];
+        for(int row = patternRowStart[pattern]; row < patternRowStart[pattern + 1]; row++)
+        {
+            trips.push_back({patternDepartureStation[pattern], arrivalTimes[row], departureTimes[row]});
+        }
+    }
+    for(int i = arrivalServiceStart[stationID - 1]; i < arrivalServiceStart[stationID]; i++)
+    {
+        std::vector<Trip> runs;
+        append_runs(frequencyServices[arrivalServices[i]], runs);
+        for(const Trip& run : runs)
+        {
+            trips.push_back({frequencyServices[arrivalServices[i]].departureStationID, run.arrivalTime, run.departureTime});
+        }
+    }
+
+    std::stable_sort(trips.begin(), trips.end(), [](const Trip& a, const Trip& b) { return a.departureTime < b.departureTime; });
+    return trips;
+}
+
+int RoutePatternTable::GetPatternCount() const
+{
+    return patternDepartureStation.size();
+}
+
+int RoutePatternTable::GetTimetableEntryCount() const
+{
+    return departureTimes.size();
+}
+
+int RoutePatternTable::GetFrequencyServiceCount() const
+{
+    return frequencyServices.size();
+}
+
+std::vector<int> RoutePatternTable::EarliestArrivals(int departureStationID, int twentyFourTime, int budgetMins, const QueryDeadline* deadline,
+    RouteStatus* status) const
+{
+    if(status) *status = RouteStatus::Complete;
+    DeadlineMonitor monitor(deadline);
+    std::vector<int> earliestArrival(stationCount, Utility::INF);
+    if(departureStationID < 1 || departureStationID > stationCount)
+    {
+        return earliestArrival;
+    }
+
+    int latestUsefulMins = budgetMins == Utility::INF ? Utility::INF : Utility::TwentyFourTimeToMinutes(twentyFourTime) + budgetMins;
+    earliestArrival[departureStationID - 1] = twentyFourTime;
+
+    // Rounds in the style of RAPTOR, round k scans the patterns leaving every station whose arrival improved in
+    // round k - 1, so it settles everything reachable with k trains. Stops once a round improves nothing.
+    std::vector<int> markedStations{departureStationID};
+    std::vector<char> marked(stationCount, 0);
+    while(markedStations.size() > 0)
+    {
+        std::vector<int> improvedStations;
+        for(int stationID : markedStations)
+        {
+            if(monitor.Expired(stationPatternStart[stationID] - stationPatternStart[stationID - 1] + 1))
+            {
+                if(status) *status = RouteStatus::TimedOut;
+                return std::vector<int>(stationCount, Utility::INF);
+            }
+
+            int readyTime = earliestArrival[stationID - 1];
+            bool atOrigin = stationID == departureStationID;
+            for(int pattern = stationPatternStart[stationID - 1]; pattern < stationPatternStart[stationID]; pattern++)
+            {
+                const int* rowBegin = departureTimes.data() + patternRowStart[pattern];
+                const int* rowEnd = departureTimes.data() + patternRowStart[pattern + 1];
+                // Board at or after the start time at the origin, strictly after arriving anywhere else.
+                const int* boardRow = atOrigin ? std::lower_bound(rowBegin, rowEnd, readyTime) : std::upper_bound(rowBegin, rowEnd, readyTime);
+                if(boardRow == rowEnd)
+                {
+                    continue;
+                }
+
+                int arrivalTime = earliestArrivalFromRow[boardRow - departureTimes.data()];
+                if(Utility::TwentyFourTimeToMinutes(arrivalTime) > latestUsefulMins)
+                {
+                    continue;
+                }
+
+                improve_arrival(patternDestinationStation[pattern], arrivalTime, earliestArrival, marked, improvedStations);
+            }
+
+            // Every run of a service takes the same time, the next run is the earliest arrival.
+            for(int service = stationServiceStart[stationID - 1]; service < stationServiceStart[stationID]; service++)
+            {
+                const FrequencyService& frequencyService = frequencyServices[service];
+                int departureTime = frequencyService.NextDeparture(readyTime, !atOrigin);
+                if(departureTime == Utility::INF)
+                {
+                    continue;
+                }
+
+                int arrivalTime = frequencyService.ArrivalTime(departureTime);
+                if(Utility::TwentyFourTimeToMinutes(arrivalTime) > latestUsefulMins)
+                {
+                    continue;
+                }
+
+                improve_arrival(frequencyService.destinationStationID, arrivalTime, earliestArrival, marked, improvedStations);
+            }
+        }
+
+        for(int stationID : improvedStations)
+        {
+            marked[stationID - 1] = 0;
+        }
+        markedStations.swap(improvedStations);
+    }
+
+    return earliestArrival;
+}
+
+void RoutePatternTable::improve_arrival(int stationID, int arrivalTime, std::vector<int>& earliestArrival, std::vector<char>& marked,
+    std::vector<int>& improvedStations) const
+{
+    if(arrivalTime < earliestArrival[stationID - 1])
+    {
+        earliestArrival[stationID - 1] = arrivalTime;
+        if(!marked[stationID - 1])
+        {
+            marked[stationID - 1] = 1;
+            improvedStations.push_back(stationID);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include "utility.hpp"
+#include "trip.hpp"
+#include "frequency_service.hpp"
+#include "query_deadline.hpp"
+#include "route.hpp"
+
+/*
+    Route pattern table groups the trips of the schedule into patterns, every trip between the same pair of stations
+    shares one pattern and the pattern stores the station ids once. Times live in per pattern timetables laid out as
+    parallel arrays (departure, arrival, and the earliest arrival of any trip from that row on), sorted by departure,
+    so engines can binary search and scan contiguous memory instead of chasing Departure vertices.
+
+    Patterns are sorted by departure station, the patterns leaving a station are one contiguous range. Frequency
+    services are kept the same way, one record per service, and their runs are computed when a query reaches them.
+
+    The table is the schedule's only per trip record once it is built. Station departure and arrival listings for the
+    printers are read out of it, nothing keeps the trains.dat records or a trip list per station.
+*/
+
+class RoutePatternTable{
+    public:
+        // stationTrips[i] holds the trips leaving station id i + 1, e.g. as read back from a graph image.
+        RoutePatternTable(std::vector<std::vector<Trip>> stationTrips);
+        // Ordinary trip records plus frequency services, which are not expanded.
+        RoutePatternTable(const std::vector<std::vector<std::string>>& tripDataTable, int stationsCount, const std::vector<FrequencyService>& services);
+        int GetPatternCount() const;
+        int GetTimetableEntryCount() const;
+        int GetFrequencyServiceCount() const;
+        // Trips leaving stationID, frequency runs included, by departure time. Empty for an unknown station.
+        std::vector<Trip> StationDepartures(int stationID) const;
+        // Trips arriving at stationID by arrival time, reversed the way the arrivals list always has been: destinationID
+        // is the station the trip came from, departureTime the arrival at stationID and arrivalTime the departure.
+        std::vector<Trip> StationArrivals(int stationID) const;
+        // Earliest arrival (HHMM) at every station, indexed by station id - 1, leaving departureStationID at or after
+        // twentyFourTime and changing trains only onto ones leaving strictly after the arrival. Stations that can't be
+        // reached within budgetMins of the start are Utility::INF. Same results as StationGraph::GetEarliestArrivals,
+        // including every station being Utility::INF and status TimedOut if deadline passes first.
+        std::vector<int> EarliestArrivals(int departureStationID, int twentyFourTime, int budgetMins, const QueryDeadline* deadline = nullptr,
+            RouteStatus* status = nullptr) const;
+    private:
+        const int stationCount;
+
+        // Pattern p runs from patternDepartureStation[p] to patternDestinationStation[p] and its timetable rows are
+        // patternRowStart[p] up to patternRowStart[p + 1]. Patterns leaving station id s are stationPatternStart[s - 1]
+        // up to stationPatternStart[s].
+        std::vector<int> patternDepartureStation;
+        std::vector<int> patternDestinationStation;
+        std::vector<int> patternRowStart;
+        std::vector<int> stationPatternStart;
+        // Patterns arriving at station id s are arrivalPatterns[arrivalPatternStart[s - 1]] up to arrivalPatternStart[s].
+        std::vector<int> arrivalPatterns;
+        std::vector<int> arrivalPatternStart;
+
+        std::vector<int> departureTimes;
+        std::vector<int> arrivalTimes;
+        // Minimum arrival over this row and every later row of the same pattern, trips can overtake each other.
+        std::vector<int> earliestArrivalFromRow;
+
+        // Sorted by departure station, services leaving station id s are stationServiceStart[s - 1] up to stationServiceStart[s].
+        std::vector<FrequencyService> frequencyServices;
+        std::vector<int> stationServiceStart;
+        // Indexes into frequencyServices, by destination station, laid out like arrivalPatterns.
+        std::vector<int> arrivalServices;
+        std::vector<int> arrivalServiceStart;
+
+        // stationTrips[i] holds the trips leaving station id i + 1.
+        void build_patterns(std::vector<std::vector<Trip>>& stationTrips);
+        void build_services(const std::vector<FrequencyService>& services);
+        // Groups 0 up to count - 1 by destinationOf into order, with start offsets per station, see arrivalPatterns.
+        template<class DestinationOf> void build_arrival_index(int count, DestinationOf destinationOf, std::vector<int>& order,
+            std::vector<int>& start) const;
+        // Appends every run of service as a trip.
+        static void append_runs(const FrequencyService& service, std::vector<Trip>& trips);
+        // Lowers the arrival at stationID and queues it for the next round if it improved.
+        void improve_arrival(int stationID, int arrivalTime, std::vector<int>& earliestArrival, std::vector<char>& marked,
+            std::vector<int>& improvedStations) const;
+};
@@ -0,0 +1,880 @@
+#include "schedule.hpp"
+
+Schedule::Schedule(std::string stationData, std::string trainsData, bool precomputeInBackground)
+{
+    skippedFrequencyRecords = 0;
+    timetableCorrupt = false;
+    build_station_lookup_table(stationData);
+    build_trip_data_table(trainsData);
+    stationGraph = new StationGraph(tripDataTable, stationLookupTable, stationLookupTable.size(), frequencyServices, precomputeInBackground);
+    graphImage = nullptr;
+    build_regional_graph();
+    release_trip_records();
+}
+
+Schedule::Schedule()
+{
+    skippedFrequencyRecords = 0;
+    timetableCorrupt = false;
+    stationGraph = nullptr;
+    regionalGraph = nullptr;
+    graphImage = nullptr;
+}
+
+Schedule* Schedule::FromGraphImage(const std::string& imagePath)
+{
+    GraphImage* image = GraphImage::Map(imagePath);
+    if(!image)
+    {
+        return nullptr;
+    }
+
+    Schedule* schedule = new Schedule();
+    schedule->graphImage = image;
+    schedule->build_tables_from_image();
+    schedule->stationGraph = new StationGraph(*image);
+    schedule->build_regional_graph();
+    schedule->release_trip_records();
+    return schedule;
+}
+
+Schedule* Schedule::ForkScenario()
+{
+    Schedule* scenario = new Schedule();
+    scenario->stationLookupTable = stationLookupTable;
+    // No regional graph, its reachability sets would ignore the scenario's cancellations.
+    scenario->stationGraph = stationGraph->Fork();
+    return scenario;
+}
+
+bool Schedule::CancelTrain(int stationID, int twentyFourTime, int nextStationID)
+{
+    return stationGraph->CancelDeparture(stationGraph->FindDepartureKey(stationID, twentyFourTime, nextStationID));
+}
+
+bool Schedule::WriteGraphImage(const std::string& imagePath)
+{
+    stationGraph->WaitForTables();
+    return GraphImage::Write(imagePath, stationLookupTable, *stationGraph);
+}
+
+void Schedule::build_regional_graph()
+{
+    regionalGraph = nullptr;
+    std::vector<std::vector<std::string>> expandedTripDataTable = tripDataTable;
+    FrequencyService::AppendTripRecords(frequencyServices, expandedTripDataTable);
+    if(RegionalStationGraph::NetworkFits(expandedTripDataTable, stationLookupTable))
+    {
+        regionalGraph = new RegionalStationGraph(expandedTripDataTable, stationLookupTable);
+    }
+}
+
+// The graphs hold everything queries and the printers read, the trip records were only needed to build them.
+void Schedule::release_trip_records()
+{
+    std::vector<std::vector<std::string>>().swap(tripDataTable);
+    std::vector<FrequencyService>().swap(frequencyServices);
+}
+
+// Recover the station and trip tables from an image, they are small next to the sequence tables
+// and keep name lookups and the regional graph working the same as for a built schedule.
+void Schedule::build_tables_from_image()
+{
+    const GraphImageStation* stationRecords = graphImage->GetStations();
+    for(int i = 0; i < graphImage->GetHeader().stationCount; i++)
+    {
+        stationLookupTable.push_back({std::to_string(stationRecords[i].stationID), graphImage->GetStationName(i)});
+
+        for(int j = 0; j < stationRecords[i].tripCount; j++)
+        {
+            Trip trip = graphImage->GetStationTrips()[stationRecords[i].tripOffset + j];
+            std::stringstream departureTime;
+            std::stringstream arrivalTime;
+            departureTime << std::setw(4) << std::setfill('0') << trip.departureTime;
+            arrivalTime << std::setw(4) << std::setfill('0') << trip.arrivalTime;
+            tripDataTable.push_back({std::to_string(stationRecords[i].stationID), std::to_string(trip.destinationID),
+                departureTime.str(), arrivalTime.str()});
+        }
+    }
+}
+
+Schedule::~Schedule()
+{
+    if(stationGraph)
+    {
+        delete stationGraph;
+    }
+    if(regionalGraph)
+    {
+        delete regionalGraph;
+    }
+    // Graph may be reading sequence tables out of the image, so the image goes last.
+    if(graphImage)
+    {
+        delete graphImage;
+    }
+}
+
+StationGraph& Schedule::GetStationGraph()
+{
+    return *stationGraph;
+}
+
+void Schedule::PrintCompleteSchedule()
+{
+    std::cout <<"                  TRAIN SCHEDULE\n";
+    for(int i = 0; i < stationLookupTable.size(); i++)
+    {
+        std::cout << "***************************************************\n";
+        PrintStationSchedule(i + 1);
+    }
+    std::cout << "******************End of Schedule******************\n";
+    
+}
+
+void Schedule::PrintStationSchedule()
+{
+    int stationID = prompt_station_id();
+    Station station = stationGraph->GetStationFromGraph(stationID);
+    std::cout << "Schedule for " << SimpleStationNameLookup(station.GetID()) << std::endl;
+
+    if (station.GetTripCount() == 0)
+    {
+        std::cout << "There are no scheduled departures for " << SimpleStationNameLookup(station.GetID()) << std::endl;
+    }
+    else
+    {
+        for (int i = 0; i < station.GetTripCount(); i++)
+        {
+            int destinationID = station.GetTrip(i).destinationID;
+            int departureTime = station.GetTrip(i).departureTime;
+            int arrivalTime = station.GetTrip(i).arrivalTime;
+            std::cout << "Departure to " << SimpleStationNameLookup(destinationID) << " at "
+                       << std::setw(4) << std::setfill('0') << departureTime << ", arriving at "
+                        << std::setw(4) << std::setfill('0') << arrivalTime << std::endl;
+        }
+    }
+
+    station = stationGraph->GetStationFromArrivalGraph(stationID);
+    if (station.GetTripCount() == 0)
+    {
+        std::cout << "There are no scheduled arrivals for " << SimpleStationNameLookup(station.GetID()) << std::endl;
+    }
+    else
+    {
+        for (int i = 0; i < station.GetTripCount(); i++)
+        {
+            int departureID = station.GetTrip(i).destinationID;
+            int arrivalTime = station.GetTrip(i).departureTime;
+            std::cout << "Arrival from " << SimpleStationNameLookup(departureID) << " at "
+                       << std::setw(4) << std::setfill('0') << arrivalTime << std::endl;
+        }
+    }
+}
+
+void Schedule::PrintStationSchedule(int stationID)
+{
+    Station station = stationGraph->GetStationFromGraph(stationID);
+
+    if (station.StationIsValid())
+    {
+        std::cout << "Schedule for " << SimpleStationNameLookup(station.GetID()) << std::endl;
+        if (station.GetTripCount() != 0)
+        {        
+            for (int i = 0; i < station.GetTripCount(); i++)
+            {
+                int destinationID = station.GetTrip(i).destinationID;
+                int departureTime = station.GetTrip(i).departureTime;
+                int arrivalTime = station.GetTrip(i).arrivalTime;
+                std::cout << "Departure to " << SimpleStationNameLookup(destinationID) << " at "
+                           << std::setw(4) << std::setfill('0') << departureTime << ", arriving at "  << std::setw(4) << std::setfill('0') 
+                           << arrivalTime << std::endl;
+            }
+        }
+        else
+        {
+            std::cout << "There are no trains leaving from "
+                << SimpleStationNameLookup(station.GetID()) << std::endl;
+        }
+
+        station = stationGraph->GetStationFromArrivalGraph(stationID);
+        if (station.GetTripCount() != 0)
+        {
+            for (int i = 0; i < station.GetTripCount(); i++)
+            {
+                int departureID = station.GetTrip(i).destinationID;
+                int arrivalTime = station.GetTrip(i).departureTime;
+                std::cout << "Arrival from " << SimpleStationNameLookup(departureID) << " at "
+                           << std::setw(4) << std::setfill('0') << arrivalTime << std::endl;
+            }
+        }
+        else
+        {
+            std::cout << "There are no scheduled arrivals for "
+                << SimpleStationNameLookup(station.GetID()) << std::endl;
+        }
+    }
+    else
+    {
+        std::cout << "There was a problem with the input\nin PrintStationSchedule, please try again.\n";
+    }       
+}
+
+void Schedule::LookUpStationId()
+{
+    std::string stationName;
+    std::cout << "Enter station name: ";
+    Utility::ClearInStream();
+    getline(std::cin, stationName);
+
+    bool noMatch = true;
+    for(int i = 0; i < stationLookupTable.size() && noMatch; i++)
+    {
+        if(Utility::CompareStringsNoCase(stationLookupTable[i][1], stationName))
+        {
+            std::string possessive = tolower(stationName[stationName.size() - 1]) == 's' ? "'" : "'s"; 
+            std::cout << stationLookupTable[i][1] << possessive << " station id is " << 
+            stationLookupTable[i][0] << std::endl;
+            noMatch = false;
+        }
+    }
+    if(noMatch)
+    {
+        std::cout <<"Invalid station name.\n";
+    }
+}
+
+void Schedule::LookUpStationName()
+{
+    int stationID;
+    std::cout << "Enter station id: ";
+    std::cin >> stationID;
+    //Clear input buffer
+    Utility::ClearInStream();
+
+    if(stationID > 0 && stationID <= stationLookupTable.size())
+    {
+        //stationID - 1 maps the input to the corresponding vector entry.
+        std::cout << "Station " << stationLookupTable[stationID - 1][0] << " is " << 
+            SimpleStationNameLookup(stationID) << std::endl;
+    }
+    else
+    {
+        std::cout <<"Invalid station id (enter value betweeen 1 and " << stationLookupTable.size() <<")\n";
+    }
+}
+
+std::string Schedule::SimpleStationNameLookup(int stationID)
+{
+    if(stationID > 0 && stationID <= stationLookupTable.size())
+    {
+        return stationLookupTable[stationID - 1][1];
+    }
+    else
+    {
+        return "INVALID";
+    }
+}
+
+int Schedule::SimpleStationIdLookup(const std::string& stationName)
+{
+    if(regionalGraph)
+    {
+        return regionalGraph->StationIdLookup(stationName);
+    }
+
+    for(int i = 0; i < stationLookupTable.size(); i++)
+    {
+        if(Utility::CompareStringsNoCase(stationLookupTable[i][1], stationName))
+        {
+            return stoi(stationLookupTable[i][0]);
+        }
+    }
+
+    return -1;
+}
+
+bool Schedule::ServiceAvailable(int departureID, int destinationID, const QueryDeadline* deadline, RouteStatus* status)
+{
+    if(regionalGraph)
+    {
+        if(status) *status = RouteStatus::Complete;
+        return regionalGraph->PathExists(departureID, destinationID);
+    }
+
+    return stationGraph->PathExists(departureID, destinationID, deadline, status);
+}
+
+bool Schedule::NonstopServiceAvailable(int departureID, int destinationID, const QueryDeadline* deadline, RouteStatus* status)
+{
+    if(regionalGraph)
+    {
+        if(status) *status = RouteStatus::Complete;
+        return regionalGraph->DirectPathExists(departureID, destinationID);
+    }
+
+    return stationGraph->DirectPathExists(departureID, destinationID, deadline, status);
+}
+
+void Schedule::GetDirectRoute()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+
+    if(NonstopServiceAvailable(stationPair.first, stationPair.second))
+    {
+
+        std::cout << "Nonstop service is available from " << SimpleStationNameLookup(stationPair.first) << 
+        " to " << SimpleStationNameLookup(stationPair.second) << std::endl;
+    }
+    else
+    {
+        std::cout << "Nonstop service is NOT available from " << SimpleStationNameLookup(stationPair.first) << 
+        " to " << SimpleStationNameLookup(stationPair.second) << std::endl;
+    }
+}
+
+void Schedule::GetRoute()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+
+    if(ServiceAvailable(stationPair.first, stationPair.second))
+    {
+
+        std::cout << "Service is available from " << SimpleStationNameLookup(stationPair.first) << 
+        " to " << SimpleStationNameLookup(stationPair.second) << std::endl;
+    }
+    else
+    {
+        std::cout << "Service is NOT available from " << SimpleStationNameLookup(stationPair.first) << 
+        " to " << SimpleStationNameLookup(stationPair.second) << std::endl;
+    }
+}
+
+void Schedule::ShortestTripLengthRideTime()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+    Route tripRoute = stationGraph->GetShortestRoute(stationPair.first, stationPair.second, false);
+
+    if (tripRoute.RouteIsValid())
+    {
+        int totalTripMins = RouteWeight<RideTimeMetric>(tripRoute);
+
+        std::cout << "\nMinimum time spent on train from " << SimpleStationNameLookup(stationPair.first)
+            << " to " << SimpleStationNameLookup(stationPair.second) << "\nis "
+            << totalTripMins / 60 << " hours and " << totalTripMins % 60
+            << " minutes. Layover time not included.\nItinerary\n----------\n";
+
+        Departure startDeparture = tripRoute.departingStation;        
+        for(int i = 0; i < tripRoute.tripList.size(); i++)
+        {
+            TripPlusLayover currentTrip = tripRoute.tripList[i];
+            Departure endDeparture = stationGraph->GetDepartureFromGraph(currentTrip.destinationKey);
+
+            std::cout << "Leave from " << SimpleStationNameLookup(startDeparture.GetStationID())
+                << " at "  << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime()
+                << ", arrive at " << SimpleStationNameLookup(endDeparture.GetStationID()) << " at "
+                 << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime() + currentTrip.rideTimeToDestinationMins << std::endl;
+
+            startDeparture = endDeparture;
+        }
+    }
+    else
+    {
+        std::cout << "There is no route from " << SimpleStationNameLookup(stationPair.first)
+            << " to " << SimpleStationNameLookup(stationPair.second) << ".\n";
+    }
+}
+
+void Schedule::ShortestTripLengthWithLayover()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+    Route tripRoute = stationGraph->GetShortestRoute(stationPair.first, stationPair.second, true);
+
+    if(tripRoute.RouteIsValid())
+    {        
+        int totalTripMins = RouteWeight<LayoverMetric>(tripRoute);
+
+        std::cout << "\nShortest overall travel time from " << SimpleStationNameLookup(stationPair.first)
+            << " to " << SimpleStationNameLookup(stationPair.second) << " \nis " 
+            << totalTripMins / 60 << " hours and " << totalTripMins % 60
+            << " minutes including layovers.\nItinerary\n----------\n";
+
+        Departure startDeparture = tripRoute.departingStation;
+        for (int i = 0; i < tripRoute.tripList.size(); i++)
+        {
+            TripPlusLayover currentTrip = tripRoute.tripList[i];
+            Departure endDeparture = stationGraph->GetDepartureFromGraph(currentTrip.destinationKey);
+
+            std::cout << "Leave from " << SimpleStationNameLookup(startDeparture.GetStationID())
+                      << " at "  << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime()
+                      << ", arrive at " << SimpleStationNameLookup(endDeparture.GetStationID()) << " at "
+                       << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime() + currentTrip.rideTimeToDestinationMins
+                       << std::endl;
+
+            startDeparture = endDeparture;
+        }
+    }
+    else
+    {
+        std::cout << "There is no route from " << SimpleStationNameLookup(stationPair.first) << " to "
+        << SimpleStationNameLookup(stationPair.second) << ".\n";
+    }
+}
+
+void Schedule::ShortestTripDepartureTime()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+    std::cout << "When would you like to leave?\n";
+
+    int time = prompt_twenty_four_time();
+    Route tripRoute = stationGraph->GetRouteFromTime(time, stationPair.first, stationPair.second);
+    if (tripRoute.RouteIsValid())
+    {
+        int totalTripMins = RouteWeight<LayoverMetric>(tripRoute);
+
+        std::cout << "\nShortest overall travel time from " << SimpleStationNameLookup(stationPair.first)
+                  << " to " << SimpleStationNameLookup(stationPair.second) << " \nis "
+                  << totalTripMins / 60 << " hours and " << totalTripMins % 60
+                  << " minutes including layovers.\nItinerary\n----------\n";
+
+        Departure startDeparture = tripRoute.departingStation;
+        for (int i = 0; i < tripRoute.tripList.size(); i++)
+        {
+            TripPlusLayover currentTrip = tripRoute.tripList[i];
+            Departure endDeparture = stationGraph->GetDepartureFromGraph(currentTrip.destinationKey);
+
+            std::cout << "Leave from " << SimpleStationNameLookup(startDeparture.GetStationID())
+                      << " at " << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime()
+                      << ", arrive at " << SimpleStationNameLookup(endDeparture.GetStationID()) << " at " 
+                      << std::setw(4) << std::setfill('0')  << startDeparture.GetDepartureTime() + currentTrip.rideTimeToDestinationMins
+                      << std::endl;
+
+            startDeparture = endDeparture;
+        }
+    }
+    else
+    {
+        std::cout << "There are no routes from " << SimpleStationNameLookup(stationPair.first) << " to "
+                  << SimpleStationNameLookup(stationPair.second) << " leaving at "  << std::setw(4) << std::setfill('0') << time;
+
+        if(time > 1300)
+        {
+            std::cout << " or " << std::setw(4) << std::setfill('0') << time - 1200 << std::endl;
+        }
+        else
+        {
+            std::cout << std::endl;
+        }
+        
+    }
+}
+
+void Schedule::ReachableWithinTime()
+{
+    int stationID = prompt_station_id();
+    std::cout << "When would you like to leave?\n";
+    int time = prompt_time_of_day();
+    std::cout << "Enter time budget in minutes (0 for no limit): ";
+    int budgetMins = Utility::GetIntFromUser();
+    if(budgetMins <= 0)
+    {
+        budgetMins = Utility::INF;
+    }
+
+    std::vector<int> earliestArrival = stationGraph->GetEarliestArrivals(stationID, time, budgetMins);
+
+    std::cout << "\nStations reachable from " << SimpleStationNameLookup(stationID) << " leaving at "
+              << std::setw(4) << std::setfill('0') << time;
+    if(budgetMins != Utility::INF)
+    {
+        std::cout << " within " << budgetMins / 60 << " hours and " << budgetMins % 60 << " minutes";
+    }
+    std::cout << "\n----------\n";
+
+    int reachableCount = 0;
+    for(int i = 0; i < earliestArrival.size(); i++)
+    {
+        if(i + 1 == stationID || earliestArrival[i] == Utility::INF)
+        {
+            continue;
+        }
+
+        int travelMins = Utility::TwentyFourTimeToMinutes(earliestArrival[i]) - Utility::TwentyFourTimeToMinutes(time);
+        std::cout << SimpleStationNameLookup(i + 1) << ", arrive at " << std::setw(4) << std::setfill('0') << earliestArrival[i]
+                  << " (" << travelMins / 60 << " hours and " << travelMins % 60 << " minutes)\n";
+        reachableCount++;
+    }
+
+    if(reachableCount == 0)
+    {
+        std::cout << "No stations can be reached.\n";
+    }
+}
+
+void Schedule::LatestTripArrivalTime()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+    std::cout << "When do you need to arrive?\n";
+
+    int time = prompt_time_of_day();
+    Route tripRoute = stationGraph->GetLatestDepartureRoute(time, stationPair.first, stationPair.second);
+    if (tripRoute.RouteIsValid())
+    {
+        int totalTripMins = RouteWeight<LayoverMetric>(tripRoute);
+
+        std::cout << "\nLatest departure from " << SimpleStationNameLookup(stationPair.first)
+                  << " to arrive at " << SimpleStationNameLookup(stationPair.second) << " by "
+                  << std::setw(4) << std::setfill('0') << time << "\nis "
+                  << std::setw(4) << std::setfill('0') << tripRoute.departingStation.GetDepartureTime() << ", total travel time "
+                  << totalTripMins / 60 << " hours and " << totalTripMins % 60
+                  << " minutes including layovers.\nItinerary\n----------\n";
+
+        print_itinerary(tripRoute);
+    }
+    else
+    {
+        std::cout << "There are no routes from " << SimpleStationNameLookup(stationPair.first) << " to "
+                  << SimpleStationNameLookup(stationPair.second) << " arriving by " << std::setw(4) << std::setfill('0') << time << std::endl;
+    }
+}
+
+void Schedule::ShortestTripWithConstraints()
+{
+    std::pair<int, int> stationPair = prompt_station_pair_id();
+    int viaID = prompt_optional_station_id("Enter station id to travel through (0 for none): ");
+    int avoidID = prompt_optional_station_id("Enter station id to avoid (0 for none): ");
+
+    RouteConstraints constraints;
+    if(viaID > 0)
+    {
+        constraints.AddViaStation(viaID);
+    }
+    if(avoidID > 0)
+    {
+        constraints.AvoidStation(avoidID);
+    }
+
+    Route tripRoute = stationGraph->GetConstrainedRoute(stationPair.first, stationPair.second, constraints, true);
+    if (tripRoute.RouteIsValid())
+    {
+        int totalTripMins = RouteWeight<LayoverMetric>(tripRoute);
+
+        std::cout << "\nShortest overall travel time from " << SimpleStationNameLookup(stationPair.first)
+                  << " to " << SimpleStationNameLookup(stationPair.second);
+        if(viaID > 0)
+        {
+            std::cout << " through " << SimpleStationNameLookup(viaID);
+        }
+        if(avoidID > 0)
+        {
+            std::cout << " avoiding " << SimpleStationNameLookup(avoidID);
+        }
+        std::cout << " \nis " << totalTripMins / 60 << " hours and " << totalTripMins % 60
+                  << " minutes including layovers.\nItinerary\n----------\n";
+
+        print_itinerary(tripRoute);
+    }
+    else
+    {
+        std::cout << "There is no route from " << SimpleStationNameLookup(stationPair.first) << " to "
+                  << SimpleStationNameLookup(stationPair.second) << " meeting those conditions.\n";
+    }
+}
+
+void Schedule::ShortestTripBetweenGroups()
+{
+    std::vector<int> departureStationIDs = prompt_station_id_list("Enter departure station ids, 0 when done: ");
+    std::vector<int> destinationStationIDs = prompt_station_id_list("Enter destination station ids, 0 when done: ");
+
+    Route tripRoute = stationGraph->GetGroupShortestRoute(departureStationIDs, destinationStationIDs, true);
+    if (tripRoute.RouteIsValid())
+    {
+        int totalTripMins = RouteWeight<LayoverMetric>(tripRoute);
+        int arrivalStationID = stationGraph->GetDepartureFromGraph(tripRoute.tripList.back().destinationKey).GetStationID();
+
+        std::cout << "\nShortest overall travel time between the groups is from " << SimpleStationNameLookup(tripRoute.departingStation.GetStationID())
+                  << " to " << SimpleStationNameLookup(arrivalStationID) << " \nand is " << totalTripMins / 60 << " hours and "
+                  << totalTripMins % 60 << " minutes including layovers.\nItinerary\n----------\n";
+
+        print_itinerary(tripRoute);
+    }
+    else
+    {
+        std::cout << "There is no route between those stations.\n";
+    }
+}
+
+void Schedule::print_itinerary(const Route& tripRoute)
+{
+    Departure startDeparture = tripRoute.departingStation;
+    for (int i = 0; i < tripRoute.tripList.size(); i++)
+    {
+        TripPlusLayover currentTrip = tripRoute.tripList[i];
+        Departure endDeparture = stationGraph->GetDepartureFromGraph(currentTrip.destinationKey);
+
+        std::cout << "Leave from " << SimpleStationNameLookup(startDeparture.GetStationID())
+                  << " at " << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime()
+                  << ", arrive at " << SimpleStationNameLookup(endDeparture.GetStationID()) << " at "
+                  << std::setw(4) << std::setfill('0') << startDeparture.GetDepartureTime() + currentTrip.rideTimeToDestinationMins
+                  << std::endl;
+
+        startDeparture = endDeparture;
+    }
+}
+
+void Schedule::build_station_lookup_table(std::string stationData)
+{
+    std::stringstream lineStream(stationData);
+    
+    std::string line;
+    while(getline(lineStream, line))
+    {
+        std::stringstream tokenStream(line);
+        std::string token;
+        stationLookupTable.push_back({});
+        while(tokenStream >> token)
+        {
+            stationLookupTable[stationLookupTable.size() - 1].push_back(token);
+        }
+    }
+
+    // sort the data in station table, not guaranteed to come in sorted.
+   std::sort(stationLookupTable.begin(), stationLookupTable.end(),
+        [](const std::vector<std::string>& a, const std::vector<std::string>& b) { return stoi(a[0]) < stoi(b[0]); });
+}
+
+void Schedule::build_trip_data_table(std::string trainsData)
+{
+    if(!TimetableReader::IsTimetable(trainsData.data(), trainsData.size()))
+    {
+        parse_trains_text(trainsData, tripDataTable, frequencyServices, skippedFrequencyRecords);
+    }
+    else
+    {
+        TimetableReader reader(trainsData.data(), trainsData.size());
+        if(!reader.ReadTripDataTable(tripDataTable) || !reader.ReadFrequencyServices(frequencyServices))
+        {
+            timetableCorrupt = true;
+            tripDataTable.clear();
+            frequencyServices.clear();
+        }
+    }
+
+    // Services are indexed by station id when the graphs are built, drop any naming a station not in stations.dat.
+    int stationCount = stationLookupTable.size();
+    std::vector<FrequencyService>::iterator knownEnd = std::remove_if(frequencyServices.begin(), frequencyServices.end(),
+        [stationCount](const FrequencyService& service) {
+            return service.departureStationID < 1 || service.departureStationID > stationCount
+                || service.destinationStationID < 1 || service.destinationStationID > stationCount;
+        });
+    skippedFrequencyRecords += frequencyServices.end() - knownEnd;
+    frequencyServices.erase(knownEnd, frequencyServices.end());
+}
+
+void Schedule::parse_trains_text(const std::string& trainsData, std::vector<std::vector<std::string>>& tripTable,
+    std::vector<FrequencyService>& services, int& skippedRecords)
+{
+    std::stringstream lineStream(trainsData);
+    
+    std::string line;
+    while(getline(lineStream, line))
+    {
+        std::stringstream tokenStream(line);
+        std::string token;
+        tripTable.push_back({});
+        while(tokenStream >> token)
+        {
+            tripTable[tripTable.size() - 1].push_back(token);
+        }
+
+        if(FrequencyService::IsFrequencyRecord(tripTable.back()))
+        {
+            FrequencyService service;
+            if(FrequencyService::FromRecord(tripTable.back(), service))
+            {
+                services.push_back(service);
+            }
+            else
+            {
+                skippedRecords++;
+            }
+            tripTable.pop_back();
+        }
+    }
+}
+
+bool Schedule::WriteTimetable(const std::string& trainsData, const std::string& timetablePath, int* skippedRecords)
+{
+    std::vector<std::vector<std::string>> tripTable;
+    std::vector<FrequencyService> services;
+    int skippedCount = 0;
+    parse_trains_text(trainsData, tripTable, services, skippedCount);
+    if(skippedRecords)
+    {
+        *skippedRecords = skippedCount;
+    }
+    return TimetableWriter::Write(timetablePath, tripTable, services);
+}
+
+int Schedule::GetSkippedFrequencyRecordCount() const
+{
+    return skippedFrequencyRecords;
+}
+
+bool Schedule::TimetableIsCorrupt() const
+{
+    return timetableCorrupt;
+}
+
+int Schedule::prompt_twenty_four_time() const
+{
+    std::cout << "Enter time (HH:MM): ";
+    std::pair<int, int> time = {-1,-1};
+
+    int firstH = 0;
+    int secondH = 0;
+    int firstM = 0;
+    int secondM = 0;   
+
+    Utility::ClearInStream(); 
+    bool valid = false;
+    while (!valid)
+    {            
+        std::string line;
+        std::getline(std::cin, line);        
+
+        firstH = line[0] - '0';
+        secondH = line[1] - '0';        
+        firstM = line[3] - '0';
+        secondM = line[4] - '0';        
+
+        if((firstH == 0 && (secondH > 0 && secondH <= 9)) ||
+            (firstH == 1 && (secondH >= 0 && secondH <= 2)) &&
+            (firstM >= 0 && firstM < 6) &&
+            (secondM >= 0 && secondM <= 9))
+        {
+            valid = true;
+        }
+        else
+        {
+            valid = false;
+            std::cout << "Invalid time, must be in HH:MM format: ";            
+        }
+    }
+
+    int twentyFourTime = 0;
+    int hour = (firstH * 10) + secondH;
+    int min = (firstM * 10) + secondM;
+    if(hour < 12 && hour > 1)
+    {
+        twentyFourTime = (hour + 12) * 100;
+    }
+    else
+    {
+        twentyFourTime = hour * 100;
+    }
+
+    return (twentyFourTime += min);    
+}
+
+int Schedule::prompt_time_of_day() const
+{
+    std::cout << "Enter time (HH:MM): ";
+    Utility::ClearInStream();
+
+    while(true)
+    {
+        std::string line;
+        std::getline(std::cin, line);
+
+        if(line.size() >= 5 && isdigit(line[0]) && isdigit(line[1]) && line[2] == ':' && isdigit(line[3]) && isdigit(line[4]))
+        {
+            int hour = (line[0] - '0') * 10 + (line[1] - '0');
+            int min = (line[3] - '0') * 10 + (line[4] - '0');
+            if(hour < 24 && min < 60)
+            {
+                return hour * 100 + min;
+            }
+        }
+
+        if(std::cin.eof())
+        {
+            return 0;
+        }
+        std::cout << "Invalid time, must be in HH:MM format: ";
+    }
+}
+
+int Schedule::prompt_station_id() const
+{
+    std::cout << "Enter station id: ";
+    int stationID = Utility::GetIntFromUser();
+    while(stationGraph->GetStationFromGraph(stationID).StationIsValid() == false)
+    {
+        std::cout << "Station id invalid, try again: ";
+        stationID = Utility::GetIntFromUser();
+    }
+
+    return stationID;
+}
+
+int Schedule::prompt_optional_station_id(const std::string& prompt) const
+{
+    std::cout << prompt;
+    int stationID = Utility::GetIntFromUser();
+    while(stationID != 0 && stationGraph->GetStationFromGraph(stationID).StationIsValid() == false)
+    {
+        std::cout << "Station id invalid, try again: ";
+        stationID = Utility::GetIntFromUser();
+    }
+
+    return stationID;
+}
+
+std::vector<int> Schedule::prompt_station_id_list(const std::string& prompt) const
+{
+    std::vector<int> stationIDs;
+    std::cout << prompt;
+    while(true)
+    {
+        int stationID = Utility::GetIntFromUser();
+        if(stationID == 0 && stationIDs.size() > 0)
+        {
+            break;
+        }
+        else if(stationGraph->GetStationFromGraph(stationID).StationIsValid())
+        {
+            stationIDs.push_back(stationID);
+        }
+        else
+        {
+            std::cout << "Station id invalid, try again: ";
+        }
+    }
+
+    return stationIDs;
+}
+
+std::pair<int, int> Schedule::prompt_station_pair_id() const
+{  
+    std::cout << "Enter departure station id: ";
+    int departID = Utility::GetIntFromUser();
+    while(stationGraph->GetStationFromGraph(departID).StationIsValid() == false)
+    {
+        std::cout << "Departure station id invalid, try again: ";
+        departID = Utility::GetIntFromUser();
+    }
+
+    std::cout << "Enter destination station id: ";
+    int destID = Utility::GetIntFromUser();
+    while(stationGraph->GetStationFromGraph(destID).StationIsValid() == false)
+    {
+        std::cout << "Destination station id invalid, try again: ";
+        destID = Utility::GetIntFromUser();
+    }
+
+    return {departID, destID};
+}
+
+
+
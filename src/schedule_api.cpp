@@ -0,0 +1,473 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include "schedule_api.h"
+#include "schedule.hpp"
+#include "query_coalescer.hpp"
+
+// Opaque handle given out to C callers. Schedule is non-const in its query interface, so the handle
+// keeps it mutable even when the caller holds a const handle.
+struct ScheduleHandle {
+    ScheduleHandle(Schedule* schedulePointer, Schedule& schedule) : schedulePointer(schedulePointer), schedule(schedule) {}
+    ~ScheduleHandle() { delete schedulePointer; }
+    Schedule* schedulePointer;
+    Schedule& schedule;
+    int timeoutMillis = 0;
+    // Shared by every thread querying through the handle.
+    mutable QueryCoalescer coalescer;
+};
+
+namespace {
+
+    // QueryKey modes for the route queries that coalesce.
+    enum RouteQueryMode { RideTimeQuery, LayoverQuery, DepartureTimeQuery, ArriveByQuery };
+
+    bool station_is_valid(const ScheduleHandle* handle, int stationID)
+    {
+        return handle && handle->schedule.GetStationGraph().GetStationFromGraph(stationID).StationIsValid();
+    }
+
+    ScheduleHandle* load_schedule(const std::string& stationData, const std::string& trainsData, bool precomputeInBackground = false)
+    {
+        // Malformed input surfaces as std::invalid_argument from stoi, never let it cross the C boundary.
+        try
+        {
+            Schedule* schedule = new Schedule(stationData, trainsData, precomputeInBackground);
+            if(schedule->TimetableIsCorrupt())
+            {
+                delete schedule;
+                return nullptr;
+            }
+            return new ScheduleHandle(schedule, *schedule);
+        }
+        catch(...)
+        {
+            return nullptr;
+        }
+    }
+
+    ScheduleHandle* load_schedule_files(const char* stationPath, const char* trainsPath, bool precomputeInBackground)
+    {
+        if(!stationPath || !trainsPath)
+        {
+            return nullptr;
+        }
+
+        std::ifstream inFile;
+        std::stringstream stationData;
+        std::stringstream trainData;
+
+        inFile.open(stationPath);
+        if(!inFile.is_open()) return nullptr;
+        stationData << inFile.rdbuf();
+        inFile.close();
+
+        inFile.open(trainsPath);
+        if(!inFile.is_open()) return nullptr;
+        trainData << inFile.rdbuf();
+        inFile.close();
+
+        // Binary timetables contain zero bytes, pass the whole buffer rather than a C string.
+        return load_schedule(stationData.str(), trainData.str(), precomputeInBackground);
+    }
+
+    // Fresh deadline for each route query, one that never expires when no timeout is set.
+    QueryDeadline query_deadline(const ScheduleHandle* handle)
+    {
+        return handle->timeoutMillis > 0 ? QueryDeadline::AfterMillis(handle->timeoutMillis) : QueryDeadline();
+    }
+
+    // Walk the route the same way the Schedule printers do and copy each leg out.
+    template<class Metric>
+    int copy_route(const ScheduleHandle* handle, Route route, ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+    {
+        if(!route.RouteIsValid())
+        {
+            if(totalMinutes) *totalMinutes = 0;
+            return route.status == RouteStatus::TimedOut ? -2 : 0;
+        }
+
+        StationGraph& graph = handle->schedule.GetStationGraph();
+        Departure startDeparture = route.departingStation;
+        for(int i = 0; i < route.tripList.size(); i++)
+        {
+            TripPlusLayover currentTrip = route.tripList[i];
+            Departure endDeparture = graph.GetDepartureFromGraph(currentTrip.destinationKey);
+
+            if(legs && i < legCapacity)
+            {
+                legs[i].departureStationID = startDeparture.GetStationID();
+                legs[i].destinationStationID = endDeparture.GetStationID();
+                legs[i].departureTime = startDeparture.GetDepartureTime();
+                legs[i].arrivalTime = startDeparture.GetDepartureTime() + currentTrip.rideTimeToDestinationMins;
+            }
+
+            startDeparture = endDeparture;
+        }
+
+        if(totalMinutes) *totalMinutes = RouteWeight<Metric>(route);
+        return route.tripList.size();
+    }
+}
+
+extern "C" {
+
+ScheduleHandle* schedule_load(const char* stationData, const char* trainsData)
+{
+    if(!stationData || !trainsData)
+    {
+        return nullptr;
+    }
+
+    return load_schedule(stationData, trainsData);
+}
+
+ScheduleHandle* schedule_load_files(const char* stationPath, const char* trainsPath)
+{
+    return load_schedule_files(stationPath, trainsPath, false);
+}
+
+ScheduleHandle* schedule_load_files_background(const char* stationPath, const char* trainsPath)
+{
+    return load_schedule_files(stationPath, trainsPath, true);
+}
+
+ScheduleHandle* schedule_load_image(const char* imagePath)
+{
+    if(!imagePath)
+    {
+        return nullptr;
+    }
+
+    Schedule* schedule = Schedule::FromGraphImage(imagePath);
+    return schedule ? new ScheduleHandle(schedule, *schedule) : nullptr;
+}
+
+int schedule_write_image(const ScheduleHandle* handle, const char* imagePath)
+{
+    if(!handle || !imagePath)
+    {
+        return 0;
+    }
+
+    return handle->schedule.WriteGraphImage(imagePath) ? 1 : 0;
+}
+
+ScheduleHandle* schedule_fork(const ScheduleHandle* handle)
+{
+    if(!handle)
+    {
+        return nullptr;
+    }
+
+    Schedule* scenario = handle->schedule.ForkScenario();
+    return new ScheduleHandle(scenario, *scenario);
+}
+
+int schedule_cancel_train(ScheduleHandle* handle, int stationID, int twentyFourTime, int nextStationID)
+{
+    if(!handle)
+    {
+        return -1;
+    }
+
+    return handle->schedule.CancelTrain(stationID, twentyFourTime, nextStationID) ? 0 : -1;
+}
+
+void schedule_free(ScheduleHandle* handle)
+{
+    delete handle;
+}
+
+int schedule_set_query_timeout(ScheduleHandle* handle, int timeoutMillis)
+{
+    if(!handle)
+    {
+        return -1;
+    }
+
+    handle->timeoutMillis = timeoutMillis;
+    return 0;
+}
+
+int schedule_tables_ready(const ScheduleHandle* handle)
+{
+    if(!handle)
+    {
+        return -1;
+    }
+
+    return handle->schedule.GetStationGraph().TablesReady() ? 1 : 0;
+}
+
+int schedule_station_count(const ScheduleHandle* handle)
+{
+    return handle ? handle->schedule.GetStationGraph().GetVertexCount() : -1;
+}
+
+int schedule_station_name(const ScheduleHandle* handle, int stationID, char* buffer, int bufferSize)
+{
+    if(!station_is_valid(handle, stationID))
+    {
+        return -1;
+    }
+
+    std::string name = handle->schedule.SimpleStationNameLookup(stationID);
+    if(buffer && bufferSize > 0)
+    {
+        int copyLength = (int)name.size() < bufferSize - 1 ? name.size() : bufferSize - 1;
+        memcpy(buffer, name.c_str(), copyLength);
+        buffer[copyLength] = '\0';
+    }
+
+    return name.size();
+}
+
+int schedule_station_id(const ScheduleHandle* handle, const char* stationName)
+{
+    if(!handle || !stationName)
+    {
+        return -1;
+    }
+
+    return handle->schedule.SimpleStationIdLookup(stationName);
+}
+
+int schedule_path_exists(const ScheduleHandle* handle, int departureStationID, int destinationStationID)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    RouteStatus status;
+    bool available = handle->schedule.ServiceAvailable(departureStationID, destinationStationID, &deadline, &status);
+    if(status == RouteStatus::TimedOut)
+    {
+        return -2;
+    }
+    return available ? 1 : 0;
+}
+
+int schedule_direct_path_exists(const ScheduleHandle* handle, int departureStationID, int destinationStationID)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    RouteStatus status;
+    bool available = handle->schedule.NonstopServiceAvailable(departureStationID, destinationStationID, &deadline, &status);
+    if(status == RouteStatus::TimedOut)
+    {
+        return -2;
+    }
+    return available ? 1 : 0;
+}
+
+int schedule_shortest_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    int includeLayovers, ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    QueryKey key{departureStationID, destinationStationID, includeLayovers ? LayoverQuery : RideTimeQuery, 0};
+    Route route = handle->coalescer.Execute(key, [&] {
+        return handle->schedule.GetStationGraph().GetShortestRoute(departureStationID, destinationStationID, includeLayovers != 0, &deadline);
+    });
+    if(includeLayovers)
+    {
+        return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+    else
+    {
+        return copy_route<RideTimeMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+}
+
+int schedule_anytime_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    int includeLayovers, int budgetMillis, ScheduleLeg* legs, int legCapacity, int* totalMinutes, int* optimal)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    Route route = handle->schedule.GetStationGraph().GetAnytimeShortestRoute(departureStationID, destinationStationID,
+        includeLayovers != 0, QueryDeadline::AfterMillis(budgetMillis));
+    if(optimal) *optimal = route.status == RouteStatus::Complete ? 1 : 0;
+    if(includeLayovers)
+    {
+        return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+    else
+    {
+        return copy_route<RideTimeMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+}
+
+int schedule_route_from_time(const ScheduleHandle* handle, int twentyFourTime, int departureStationID,
+    int destinationStationID, ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    QueryKey key{departureStationID, destinationStationID, DepartureTimeQuery, twentyFourTime};
+    Route route = handle->coalescer.Execute(key, [&] {
+        return handle->schedule.GetStationGraph().GetRouteFromTime(twentyFourTime, departureStationID, destinationStationID, &deadline);
+    });
+    return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+}
+
+int schedule_route_arrive_by(const ScheduleHandle* handle, int arriveByTime, int departureStationID,
+    int destinationStationID, ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    QueryKey key{departureStationID, destinationStationID, ArriveByQuery, arriveByTime};
+    Route route = handle->coalescer.Execute(key, [&] {
+        return handle->schedule.GetStationGraph().GetLatestDepartureRoute(arriveByTime, departureStationID, destinationStationID, &deadline);
+    });
+    return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+}
+
+int schedule_constrained_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    const int* viaStationIDs, int viaCount, const int* avoidedStationIDs, int avoidedCount, int includeLayovers,
+    ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+{
+    if(!station_is_valid(handle, departureStationID) || !station_is_valid(handle, destinationStationID)
+        || (viaCount > 0 && !viaStationIDs) || (avoidedCount > 0 && !avoidedStationIDs))
+    {
+        return -1;
+    }
+
+    RouteConstraints constraints;
+    for(int i = 0; i < viaCount; i++)
+    {
+        constraints.AddViaStation(viaStationIDs[i]);
+    }
+    for(int i = 0; i < avoidedCount; i++)
+    {
+        constraints.AvoidStation(avoidedStationIDs[i]);
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    Route route = handle->schedule.GetStationGraph().GetConstrainedRoute(departureStationID, destinationStationID, constraints, includeLayovers != 0, &deadline);
+    if(includeLayovers)
+    {
+        return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+    else
+    {
+        return copy_route<RideTimeMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+}
+
+int schedule_group_shortest_route(const ScheduleHandle* handle, const int* departureStationIDs, int departureCount,
+    const int* destinationStationIDs, int destinationCount, int includeLayovers, ScheduleLeg* legs, int legCapacity, int* totalMinutes)
+{
+    if(!handle || !departureStationIDs || !destinationStationIDs || departureCount <= 0 || destinationCount <= 0)
+    {
+        return -1;
+    }
+
+    std::vector<int> departures(departureStationIDs, departureStationIDs + departureCount);
+    std::vector<int> destinations(destinationStationIDs, destinationStationIDs + destinationCount);
+    QueryDeadline deadline = query_deadline(handle);
+    Route route = handle->schedule.GetStationGraph().GetGroupShortestRoute(departures, destinations, includeLayovers != 0, &deadline);
+    if(includeLayovers)
+    {
+        return copy_route<LayoverMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+    else
+    {
+        return copy_route<RideTimeMetric>(handle, route, legs, legCapacity, totalMinutes);
+    }
+}
+
+int schedule_earliest_arrivals(const ScheduleHandle* handle, int departureStationID, int twentyFourTime, int budgetMins,
+    int* arrivals, int arrivalCapacity)
+{
+    if(!station_is_valid(handle, departureStationID))
+    {
+        return -1;
+    }
+
+    QueryDeadline deadline = query_deadline(handle);
+    RouteStatus status;
+    std::vector<int> earliestArrival = handle->schedule.GetStationGraph().GetEarliestArrivals(departureStationID, twentyFourTime,
+        budgetMins > 0 ? budgetMins : Utility::INF, &deadline, &status);
+    if(status == RouteStatus::TimedOut)
+    {
+        return -2;
+    }
+
+    for(int i = 0; arrivals && i < earliestArrival.size() && i < arrivalCapacity; i++)
+    {
+        arrivals[i] = earliestArrival[i] == Utility::INF ? -1 : earliestArrival[i];
+    }
+
+    return earliestArrival.size();
+}
+
+int schedule_train_earliest_arrival(const ScheduleHandle* handle, int stationID, int twentyFourTime, int nextStationID,
+    int destinationStationID)
+{
+    if(!station_is_valid(handle, stationID) || !station_is_valid(handle, destinationStationID))
+    {
+        return -1;
+    }
+
+    StationGraph& graph = handle->schedule.GetStationGraph();
+    QueryDeadline deadline = query_deadline(handle);
+    RouteStatus status;
+    int arrival = graph.GetEarliestArrivalFromDeparture(graph.FindDepartureKey(stationID, twentyFourTime, nextStationID), destinationStationID,
+        &deadline, &status);
+    if(status == RouteStatus::TimedOut)
+    {
+        return -2;
+    }
+    return arrival != Utility::INF ? arrival : -1;
+}
+
+int schedule_travel_time_matrix(const ScheduleHandle* handle, const int* originIDs, int originCount, const int* destinationIDs,
+    int destinationCount, int includeLayovers, int threadCount, int* matrix)
+{
+    if(!handle || !originIDs || !destinationIDs || !matrix || originCount < 0 || destinationCount < 0)
+    {
+        return -1;
+    }
+
+    std::vector<int> origins(originIDs, originIDs + originCount);
+    std::vector<int> destinations(destinationIDs, destinationIDs + destinationCount);
+    QueryDeadline deadline = query_deadline(handle);
+    RouteStatus status;
+    std::vector<int> weights = handle->schedule.GetStationGraph().GetTravelTimeMatrix(origins, destinations, includeLayovers != 0, threadCount,
+        nullptr, &deadline, &status);
+    if(status == RouteStatus::TimedOut)
+    {
+        return -2;
+    }
+
+    for(int i = 0; i < weights.size(); i++)
+    {
+        matrix[i] = weights[i] == Utility::INF ? -1 : weights[i];
+    }
+
+    return 0;
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+    C interface to the scheduler library (libschedule.a) for embedding in other services.
+
+    A handle owns a built Schedule. Queries never prompt or print, results are written into
+    caller-owned buffers. Route queries return the number of legs in the route, 0 if there is no route,
+    -1 for a bad handle or station id and -2 if the query ran past the handle's timeout. If the return
+    value is larger than legCapacity only the first legCapacity legs were written and the caller can
+    retry with a larger buffer. The timeout applies to every query that searches, and they all return
+    -2 when it passes.
+
+    Handles can be shared between threads. Identical shortest route, route from time and arrive by queries that are
+    in flight on one handle at the same time share a single search and its timeout (see query_coalescer.hpp).
+
+    Times are in 24 hour HHMM form, the same as trains.dat.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ScheduleHandle ScheduleHandle;
+
+typedef struct ScheduleLeg {
+    int departureStationID;
+    int destinationStationID;
+    int departureTime;
+    int arrivalTime;
+} ScheduleLeg;
+
+// Build a schedule from the contents of stations.dat and trains.dat. Returns NULL on failure. Binary timetables
+// hold zero bytes and can only be loaded with schedule_load_files.
+ScheduleHandle* schedule_load(const char* stationData, const char* trainsData);
+// Build a schedule from file paths. Returns NULL on failure, including a binary timetable that can't be read.
+ScheduleHandle* schedule_load_files(const char* stationPath, const char* trainsPath);
+// Same as schedule_load_files, but returns once the departure graph is built and builds the precomputed tables on a
+// background thread. Queries are answered on demand until the tables are ready, see schedule_tables_ready.
+ScheduleHandle* schedule_load_files_background(const char* stationPath, const char* trainsPath);
+// Map a graph image written by schedule_write_image (see graph_image.hpp). Returns NULL on failure.
+ScheduleHandle* schedule_load_image(const char* imagePath);
+// Write the built graph so other processes can map it. Returns 1 on success, 0 on failure.
+int schedule_write_image(const ScheduleHandle* handle, const char* imagePath);
+// What-if scenario sharing the schedule's graph, free it with schedule_free before the schedule it came from.
+// Scenarios answer every query below on demand, without the precomputed tables. Returns NULL on failure.
+ScheduleHandle* schedule_fork(const ScheduleHandle* handle);
+// Cancel the train leaving stationID at twentyFourTime for nextStationID in a scenario. Returns 0 on success, -1 if
+// the handle is not a scenario or there is no such train.
+int schedule_cancel_train(ScheduleHandle* handle, int stationID, int twentyFourTime, int nextStationID);
+void schedule_free(ScheduleHandle* handle);
+// Give up on route queries that take longer than timeoutMillis, 0 or less for no limit (the default). Set it
+// before sharing the handle between threads. Returns 0, or -1 for a bad handle.
+int schedule_set_query_timeout(ScheduleHandle* handle, int timeoutMillis);
+// 1 if queries are answered from the precomputed tables, 0 while a background build is running and for scenarios,
+// -1 for a bad handle.
+int schedule_tables_ready(const ScheduleHandle* handle);
+
+int schedule_station_count(const ScheduleHandle* handle);
+// Copies the station name into buffer, returns the full name length or -1 for a bad station id.
+int schedule_station_name(const ScheduleHandle* handle, int stationID, char* buffer, int bufferSize);
+// Returns the station id for a name, or -1 if there is no match.
+int schedule_station_id(const ScheduleHandle* handle, const char* stationName);
+
+// Return 1 if service (or nonstop service) is available, 0 if not, -1 on bad arguments, -2 on timeout.
+int schedule_path_exists(const ScheduleHandle* handle, int departureStationID, int destinationStationID);
+int schedule_direct_path_exists(const ScheduleHandle* handle, int departureStationID, int destinationStationID);
+
+// Shortest route by ride time only (includeLayovers == 0) or by ride time plus layovers.
+// totalMinutes may be NULL.
+int schedule_shortest_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    int includeLayovers, ScheduleLeg* legs, int legCapacity, int* totalMinutes);
+// schedule_shortest_route within budgetMillis. Trains out of the origin are tried earliest first, and when the
+// budget runs out the best route found so far is returned. optimal (may be NULL) is set to 1 if every train was tried
+// and the route is the shortest, 0 if the budget ran out first. Returns -2 only if nothing was found in the budget.
+// The handle's query timeout does not apply.
+int schedule_anytime_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    int includeLayovers, int budgetMillis, ScheduleLeg* legs, int legCapacity, int* totalMinutes, int* optimal);
+// Shortest overall route leaving at twentyFourTime.
+int schedule_route_from_time(const ScheduleHandle* handle, int twentyFourTime, int departureStationID,
+    int destinationStationID, ScheduleLeg* legs, int legCapacity, int* totalMinutes);
+
+// Route leaving as late as possible and arriving at the destination by arriveByTime.
+int schedule_route_arrive_by(const ScheduleHandle* handle, int arriveByTime, int departureStationID,
+    int destinationStationID, ScheduleLeg* legs, int legCapacity, int* totalMinutes);
+
+// Shortest route that changes trains at each via station in order and never uses an avoided station.
+// Either list may be NULL when its count is 0.
+int schedule_constrained_route(const ScheduleHandle* handle, int departureStationID, int destinationStationID,
+    const int* viaStationIDs, int viaCount, const int* avoidedStationIDs, int avoidedCount, int includeLayovers,
+    ScheduleLeg* legs, int legCapacity, int* totalMinutes);
+
+// Shortest route from any station in departureStationIDs to any station in destinationStationIDs.
+int schedule_group_shortest_route(const ScheduleHandle* handle, const int* departureStationIDs, int departureCount,
+    const int* destinationStationIDs, int destinationCount, int includeLayovers, ScheduleLeg* legs, int legCapacity, int* totalMinutes);
+
+// Earliest arrival (HHMM) at every station leaving departureStationID at or after twentyFourTime. arrivals[i] is for
+// station id i + 1 and is -1 if that station can't be reached within budgetMins (0 or less for no limit).
+// Returns the number of stations, only the first arrivalCapacity are written, or -2 on timeout.
+int schedule_earliest_arrivals(const ScheduleHandle* handle, int departureStationID, int twentyFourTime, int budgetMins,
+    int* arrivals, int arrivalCapacity);
+
+// Earliest arrival (HHMM) at destinationStationID for a rider on the train leaving stationID at twentyFourTime for
+// nextStationID. Returns -1 if there is no such train or it can't reach the destination, -2 on timeout.
+int schedule_train_earliest_arrival(const ScheduleHandle* handle, int stationID, int twentyFourTime, int nextStationID,
+    int destinationStationID);
+
+// Fills matrix (originCount x destinationCount, row-major, caller-owned) with shortest route weights in minutes,
+// -1 where there is no route. threadCount 0 uses one thread per hardware thread. Returns 0, -1 on bad arguments or -2
+// on timeout, when the matrix is left unfilled.
+int schedule_travel_time_matrix(const ScheduleHandle* handle, const int* originIDs, int originCount, const int* destinationIDs,
+    int destinationCount, int includeLayovers, int threadCount, int* matrix);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,38 @@
+#include "sequence_table.hpp"
+
+SequenceTable::SequenceTable(int tableSize, int fillValue) : storage((size_t)tableSize * tableSize, fillValue)
+{
+    data = storage.data();
+    size = tableSize;
+}
+
+SequenceTable::SequenceTable(const int* tableData, int tableSize)
+{
+    data = tableData;
+    size = tableSize;
+}
+
+const int* SequenceTable::operator[](int row) const
+{
+    return data + (size_t)row * size;
+}
+
+int* SequenceTable::Row(int row)
+{
+    return storage.data() + (size_t)row * size;
+}
+
+const int* SequenceTable::Data() const
+{
+    return data;
+}
+
+int SequenceTable::Size() const
+{
+    return size;
+}
+
+bool SequenceTable::IsView() const
+{
+    return storage.empty() && size > 0;
+}
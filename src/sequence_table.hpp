@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/*
+    Shortest path sequence table stored as one contiguous row-major block of size x size next-hop keys.
+    It either owns its storage (built by floyd_warshal_shortest_paths) or is a read-only view of a block owned
+    elsewhere, such as a mapped graph image shared between processes. Rows are read with table[row][column].
+*/
+
+class SequenceTable{
+    public:
+        // Owning table with every entry set to fillValue.
+        SequenceTable(int tableSize, int fillValue);
+        // Read-only view of tableSize * tableSize entries owned by the caller.
+        SequenceTable(const int* tableData, int tableSize);
+        SequenceTable(const SequenceTable&) = delete;
+        SequenceTable& operator=(const SequenceTable&) = delete;
+        const int* operator[](int row) const;
+        // Writable row, only valid for owning tables.
+        int* Row(int row);
+        const int* Data() const;
+        int Size() const;
+        bool IsView() const;
+    private:
+        std::vector<int> storage;
+        const int* data;
+        int size;
+};
@@ -0,0 +1,27 @@
+#include "station.hpp"
+
+Station::Station(int ID, std::vector<Trip> tripArray)
+{
+    trips = tripArray;
+    stationID = ID;
+}
+
+bool Station::StationIsValid() const
+{
+    return (stationID > 0);
+}
+
+Trip Station::GetTrip(int tripIndex) const
+{
+    return trips[tripIndex];
+}
+
+int Station::GetTripCount() const
+{
+    return trips.size();
+}
+
+int Station::GetID() const
+{
+    return stationID;
+}
@@ -13,29 +13,3 @@ class Station {
         std::vector<Trip> trips;
         int stationID;
 };
-
-Station::Station(int ID, std::vector<Trip> tripArray)
-{
-    trips = tripArray;
-    stationID = ID;
-}
-
-bool Station::StationIsValid() const
-{
-    return (stationID > 0);
-}
-
-Trip Station::GetTrip(int tripIndex) const
-{
-    return trips[tripIndex];
-}
-
-int Station::GetTripCount() const
-{
-    return trips.size();
-}
-
-int Station::GetID() const
-{
-    return stationID;
-}
\ No newline at end of file
@@ -0,0 +1,637 @@
+#include <tuple>
+#include <algorithm>
+#include "station_graph.hpp"
+
+StationGraph::StationGraph(std::vector<std::vector<std::string>> const tripDataTable, std::vector<std::vector<std::string>> const stationDataTable, int stationsCount,
+    const std::vector<FrequencyService>& frequencyServices, bool precomputeInBackground) : stationCount(stationsCount), baseGraph(nullptr),
+    tablesReady(false), stopTableBuild(false)
+{
+    // The departure graph and its tables need a vertex per run, the pattern table computes runs as it goes.
+    std::vector<std::vector<std::string>> expandedTripDataTable = tripDataTable;
+    FrequencyService::AppendTripRecords(frequencyServices, expandedTripDataTable);
+    routePatternTable = new RoutePatternTable(tripDataTable, stationsCount, frequencyServices);
+
+    std::vector<int> recordIndexTable;
+    build_departures_graph(expandedTripDataTable, stationDataTable, recordIndexTable);
+    build_search_indexes(recordIndexTable);
+
+    hubLabelIndex = nullptr;
+    shortestRouteWithLayoverSequenceTable = nullptr;
+    shortestRouteWithoutLayoverSequenceTable = nullptr;
+    if(precomputeInBackground)
+    {
+        tableThread = std::thread(&StationGraph::build_sequence_tables, this);
+    }
+    else
+    {
+        build_sequence_tables();
+    }
+}
+
+void StationGraph::build_sequence_tables()
+{
+    // Build shortest path lookup table for both including layovers, and for not including layvoers.
+    SequenceTable* layoverTable = floyd_warshal_shortest_paths<LayoverMetric>();
+    SequenceTable* rideTable = layoverTable ? floyd_warshal_shortest_paths<RideTimeMetric>() : nullptr;
+    if(!rideTable || stopTableBuild)
+    {
+        if(layoverTable) delete layoverTable;
+        if(rideTable) delete rideTable;
+        return;
+    }
+
+    // Hub labels are published with the tables, the label build itself can't be stopped part way.
+    shortestRouteWithLayoverSequenceTable = layoverTable;
+    shortestRouteWithoutLayoverSequenceTable = rideTable;
+    hubLabelIndex = new HubLabelIndex(*departureGraphList, searchIndexes->predecessorTable);
+    tablesReady.store(true, std::memory_order_release);
+}
+
+StationGraph::StationGraph(const GraphImage& image) : stationCount(image.GetHeader().stationCount), baseGraph(nullptr),
+    tablesReady(true), stopTableBuild(false)
+{
+    const GraphImageHeader& header = image.GetHeader();
+    const GraphImageStation* stationRecords = image.GetStations();
+
+    std::vector<std::vector<Trip>> stationTrips;
+    for(int i = 0; i < header.stationCount; i++)
+    {
+        const Trip* trips = image.GetStationTrips() + stationRecords[i].tripOffset;
+        stationTrips.push_back(std::vector<Trip>(trips, trips + stationRecords[i].tripCount));
+    }
+    routePatternTable = new RoutePatternTable(stationTrips);
+
+    departureGraphList = new DepartureBlockList;
+    std::vector<int> recordIndexTable;
+    for(int i = 0; i < header.departureCount; i++)
+    {
+        const GraphImageDeparture& record = image.GetDepartures()[i];
+        const TripPlusLayover* edges = image.GetEdges() + record.edgeOffset;
+        departureGraphList->push_back({std::vector<TripPlusLayover>(edges, edges + record.edgeCount), record.stationID, record.lookUpKey, record.departureTime});
+        recordIndexTable.push_back(record.recordIndex);
+    }
+
+    build_search_indexes(recordIndexTable);
+
+    // The V x V tables are the bulk of the graph, they and the hub labels stay in the shared mapping.
+    shortestRouteWithLayoverSequenceTable = new SequenceTable(image.GetLayoverTable(), header.departureCount);
+    shortestRouteWithoutLayoverSequenceTable = new SequenceTable(image.GetRideTable(), header.departureCount);
+    hubLabelIndex = new HubLabelIndex(image.GetOutLabelOffsets(), image.GetOutLabelEntries(), image.GetInLabelOffsets(),
+        image.GetInLabelEntries(), header.departureCount);
+}
+
+StationGraph::StationGraph(const StationGraph* forkedFrom) : stationCount(forkedFrom->stationCount), baseGraph(forkedFrom),
+    tablesReady(false), stopTableBuild(false)
+{
+    departureGraphList = new DepartureBlockList(*forkedFrom->departureGraphList);
+    searchIndexes = forkedFrom->searchIndexes;
+
+    // Built from the base timetable, they would ignore the scenario's edits. Station listings still come from the
+    // base graph's pattern table, see station_timetable.
+    routePatternTable = nullptr;
+    hubLabelIndex = nullptr;
+    shortestRouteWithLayoverSequenceTable = nullptr;
+    shortestRouteWithoutLayoverSequenceTable = nullptr;
+}
+
+StationGraph::~StationGraph()
+{
+    stopTableBuild = true;
+    WaitForTables();
+
+    if(routePatternTable) delete routePatternTable;
+    if(departureGraphList) delete departureGraphList;
+    if(shortestRouteWithLayoverSequenceTable) delete shortestRouteWithLayoverSequenceTable;
+    if(shortestRouteWithoutLayoverSequenceTable) delete shortestRouteWithoutLayoverSequenceTable;
+    if(hubLabelIndex) delete hubLabelIndex;
+}
+
+bool StationGraph::station_records_match(int Key1, int Key2, const std::vector<std::vector<std::string>>& tripDataTable)
+{
+    return (stoi(tripDataTable[Key1][0]) == stoi(tripDataTable[Key2][0])
+        && stoi(tripDataTable[Key1][1]) == stoi(tripDataTable[Key2][1])
+        && stoi(tripDataTable[Key1][2]) == stoi(tripDataTable[Key2][2])
+        && stoi(tripDataTable[Key1][3]) == stoi(tripDataTable[Key2][3]));
+}
+
+void StationGraph::build_departures_graph(std::vector<std::vector<std::string>> tripDataTable, std::vector<std::vector<std::string>> stationDataTable,
+    std::vector<int>& recordIndexTable)
+{
+    departureGraphList = new DepartureBlockList;
+    std::vector<std::pair<std::pair<int, int>, std::vector<TripPlusLayover>>> tempTripTable; 
+
+    for(int i = 0; i < tripDataTable.size(); i++)
+    {
+        tempTripTable.push_back({});
+    }
+
+    for(int i = 0; i < tripDataTable.size(); i++)
+    {        
+        int destinationKey;
+        int departureTime = stoi(tripDataTable[i][2]);
+        int rideTimeToDestination = stoi(tripDataTable[i][3]) - stoi(tripDataTable[i][2]);
+        int layoverAtDestination = 0; // this node marks end of trip, no layover added.
+        int totalTripTime = rideTimeToDestination + layoverAtDestination;
+
+        // Map trip target station id to the lookUpKey of the vertex.
+        for(int keyIndx = 0; keyIndx < tripDataTable.size(); keyIndx++)
+        {
+            if(station_records_match(keyIndx, i, tripDataTable))
+            {   
+                // Map terminating destinations to the appropriate keys at the end of the look up table.             
+                destinationKey = stoi(tripDataTable[keyIndx][1]) + (tripDataTable.size() - 1);
+            }
+        }
+
+        for(int k = 0; k < tripDataTable.size(); k++)
+        {
+            //If the target edge departure time and departure station match, this is the correct insertion point, add edge to adjacency list.
+            if(station_records_match(k, i, tripDataTable))
+            {
+                tempTripTable[k].first.first = departureTime;
+                tempTripTable[k].first.second = stoi(tripDataTable[i][0]);
+                tempTripTable[k].second.push_back({destinationKey, rideTimeToDestination, layoverAtDestination, totalTripTime});                
+            }
+        }
+        
+        for(int j = 0; j < tripDataTable.size(); j++)
+        {                        
+            if(j != i && tripDataTable[i][1] == tripDataTable[j][0] && tripDataTable[i][3] < tripDataTable[j][2])
+            {
+                departureTime = stoi(tripDataTable[i][2]);
+                rideTimeToDestination = stoi(tripDataTable[i][3]) - stoi(tripDataTable[i][2]);
+                layoverAtDestination = stoi(tripDataTable[j][2]) - stoi(tripDataTable[i][3]);
+                totalTripTime = rideTimeToDestination + layoverAtDestination;
+
+                // Map trip ID to its corresponding key value for easy look up.
+                for (int keyIndx = 0; keyIndx < tripDataTable.size(); keyIndx++)
+                {
+                    if (station_records_match(keyIndx, j, tripDataTable))
+                    {
+                        destinationKey = keyIndx;
+                    }
+                }
+
+                // Search adjacency list for matching vertex to insert new edge data. Can't be a simple index with current setup.
+                // This is the only time this search must happen because when the graph is created, each departure is assigned a lookupKey that can be used
+                // to index the list and match the vertex.
+                for (int k = 0; k < tripDataTable.size(); k++)
+                {
+                    //If the target edge departure time and departure station match, this is the correct insertion point, add edge to adjacency list.
+                    if (station_records_match(k, i, tripDataTable))
+                    {
+                        tempTripTable[k].first.first = departureTime;
+                        tempTripTable[k].first.second = stoi(tripDataTable[i][0]);
+                        tempTripTable[k].second.push_back({destinationKey, rideTimeToDestination, layoverAtDestination, totalTripTime});
+                    }
+                }
+            }
+        }
+    }
+
+    // Terminating arrival nodes, required for shortest path algortithm, follow the trips in record order.
+    for(int i = 0; i < stationDataTable.size(); i++)
+    {
+        tempTripTable.push_back({{0, stoi(stationDataTable[i][0])}, {}});
+    }
+
+    // Keys so far are record indexes, trains.dat line order then terminals. Renumber the vertices by station and then
+    // departure time, so a station's departures, which every transfer into the station fans out to, sit together in
+    // departureGraphList and in the rows of the sequence tables.
+    recordIndexTable.resize(tempTripTable.size());
+    for(int i = 0; i < recordIndexTable.size(); i++)
+    {
+        recordIndexTable[i] = i;
+    }
+    std::sort(recordIndexTable.begin(), recordIndexTable.end(), [&tempTripTable](int record1, int record2) {
+        return std::make_tuple(tempTripTable[record1].first.second, tempTripTable[record1].first.first, record1)
+            < std::make_tuple(tempTripTable[record2].first.second, tempTripTable[record2].first.first, record2);
+    });
+
+    std::vector<int> departureKeyTable(recordIndexTable.size());
+    for(int key = 0; key < recordIndexTable.size(); key++)
+    {
+        departureKeyTable[recordIndexTable[key]] = key;
+    }
+
+    // Populate the departure graph using data from tempTripTable.
+    for(int key = 0; key < recordIndexTable.size(); key++)
+    {
+        std::vector<TripPlusLayover> trips = tempTripTable[recordIndexTable[key]].second;
+        for(TripPlusLayover& trip : trips)
+        {
+            trip.destinationKey = departureKeyTable[trip.destinationKey];
+        }
+        departureGraphList->push_back({trips, tempTripTable[recordIndexTable[key]].first.second, key, tempTripTable[recordIndexTable[key]].first.first});
+    }
+}
+
+Route StationGraph::get_route(int departureKey, int destinationKey, const SequenceTable& routeLookUpTable)
+{        
+    std::vector<TripPlusLayover> shortPath;
+    
+    int nextStopID = departureKey;
+    while(advance_route_walk(nextStopID, destinationKey, routeLookUpTable, shortPath))
+    {
+    }
+
+    return walked_route(departureKey, shortPath);
+}
+
+bool StationGraph::advance_route_walk(int& currentKey, int destinationKey, const SequenceTable& routeLookUpTable,
+    std::vector<TripPlusLayover>& path)
+{
+    const Departure& currentNode = (*departureGraphList)[currentKey];
+    int nextStopID = routeLookUpTable[currentKey][destinationKey];
+    if(nextStopID == Utility::INF)
+    {
+        return false;
+    }
+
+    // Each hop lands in a different table row, start on the next one while this vertex's edges are searched.
+    Utility::Prefetch(&routeLookUpTable[nextStopID][destinationKey]);
+    Utility::Prefetch(&(*departureGraphList)[nextStopID]);
+    path.push_back(currentNode.FindTripByDestinationKey(nextStopID));
+    if(currentNode.IsFinalDestination())
+    {
+        return false;
+    }
+
+    currentKey = nextStopID;
+    return true;
+}
+
+Route StationGraph::walked_route(int departureKey, std::vector<TripPlusLayover>& path)
+{
+    Route finalRoute{(*departureGraphList)[departureKey], std::move(path)};
+
+    if(finalRoute.RouteIsValid())
+    {        
+        return finalRoute;
+    }
+    else
+    {        
+        return{{{}, -1, -1, -1} ,{}};
+    }            
+}
+
+void StationGraph::get_routes(int departureKey, const std::vector<int>& destinationKeys, const SequenceTable& routeLookUpTable,
+    std::vector<Route>& routes)
+{
+    routes.clear();
+    for(int batchStart = 0; batchStart < destinationKeys.size(); batchStart += RouteWalkBatch)
+    {
+        int batchSize = std::min<int>(RouteWalkBatch, destinationKeys.size() - batchStart);
+        int currentKeys[RouteWalkBatch];
+        bool walking[RouteWalkBatch];
+        std::vector<TripPlusLayover> paths[RouteWalkBatch];
+        for(int lane = 0; lane < batchSize; lane++)
+        {
+            currentKeys[lane] = departureKey;
+            walking[lane] = true;
+            Utility::Prefetch(&routeLookUpTable[departureKey][destinationKeys[batchStart + lane]]);
+        }
+
+        // A round takes one hop on every walk still going, so each lane's next row loads while the others are stepped.
+        int walkingCount = batchSize;
+        while(walkingCount > 0)
+        {
+            for(int lane = 0; lane < batchSize; lane++)
+            {
+                if(walking[lane] && !advance_route_walk(currentKeys[lane], destinationKeys[batchStart + lane], routeLookUpTable, paths[lane]))
+                {
+                    walking[lane] = false;
+                    walkingCount--;
+                }
+            }
+        }
+
+        for(int lane = 0; lane < batchSize; lane++)
+        {
+            routes.push_back(walked_route(departureKey, paths[lane]));
+        }
+    }
+}
+
+bool StationGraph::direct_route_exists(int departureID, int destinationID, const SequenceTable& routeLookUpTable, const QueryDeadline* deadline,
+    RouteStatus* status)
+{
+    DeadlineMonitor monitor(deadline);
+    if(departureID < 1 || departureID > stationCount || destinationID < 1 || destinationID > stationCount)
+    {
+        return false;
+    }
+
+    std::vector<Route> walkedRoutes;
+    for (int j : searchIndexes->stationVertexIndex[departureID - 1])
+    {
+        if(monitor.Expired(searchIndexes->stationVertexIndex[destinationID - 1].size()))
+        {
+            if(status) *status = RouteStatus::TimedOut;
+            return false;
+        }
+
+        get_routes(j, searchIndexes->stationVertexIndex[destinationID - 1], routeLookUpTable, walkedRoutes);
+        for (Route& potentialRoute : walkedRoutes)
+        {
+            if (potentialRoute.RouteIsValid())
+            {
+                if(potentialRoute.tripList.size() == 1)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+template<class Metric>
+Route StationGraph::get_shortest_route(int departureID, int destinationID, const SequenceTable& routeLookUpTable, const QueryDeadline* deadline)
+{
+    std::vector<Route> potentialRouteList;
+    DeadlineMonitor monitor(deadline);
+    if(departureID < 1 || departureID > stationCount || destinationID < 1 || destinationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    // Every pair of vertices at the two stations, in record order so the first of equally short routes wins.
+    const std::vector<int>& destinationKeys = searchIndexes->stationVertexIndex[destinationID - 1];
+    std::vector<Route> walkedRoutes;
+    for (int j : searchIndexes->stationVertexIndex[departureID - 1])
+    {
+        if(monitor.Expired(destinationKeys.size()))
+        {
+            return {{{}, -1, -1, -1}, {}, RouteStatus::TimedOut};
+        }
+
+        get_routes(j, destinationKeys, routeLookUpTable, walkedRoutes);
+        for (Route& potentialRoute : walkedRoutes)
+        {
+            if (potentialRoute.RouteIsValid())
+            {
+                potentialRouteList.push_back(std::move(potentialRoute));
+            }
+        }
+    }
+
+    if (potentialRouteList.size() > 0)
+    {
+        //Determine which route is shortest and return it.
+        int minimumWeight = Utility::INF;
+        int shortestRouteIndex = -1;
+        for (int i = 0; i < potentialRouteList.size(); i++)
+        {
+            int totalCurrentWeight = RouteWeight<Metric>(potentialRouteList[i]);
+
+            if (totalCurrentWeight < minimumWeight)
+            {
+                minimumWeight = totalCurrentWeight;
+                totalCurrentWeight = 0;
+                shortestRouteIndex = i;
+            }
+        }
+
+        return potentialRouteList[shortestRouteIndex];
+    }
+    else
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+}
+
+Route StationGraph::get_shortest_route_from_time(int departureID, int destinationID, int twentyFourTime, const QueryDeadline* deadline)
+{
+    std::vector<Route> potentialRouteList;
+    DeadlineMonitor monitor(deadline);
+    if(departureID < 1 || departureID > stationCount || destinationID < 1 || destinationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    const std::vector<int>& destinationKeys = searchIndexes->stationVertexIndex[destinationID - 1];
+    std::vector<Route> walkedRoutes;
+    for (int j : searchIndexes->stationVertexIndex[departureID - 1])
+    {
+        if(monitor.Expired(destinationKeys.size()))
+        {
+            return {{{}, -1, -1, -1}, {}, RouteStatus::TimedOut};
+        }
+
+        get_routes(j, destinationKeys, *shortestRouteWithLayoverSequenceTable, walkedRoutes);
+        for (Route& potentialRoute : walkedRoutes)
+        {
+            if (potentialRoute.RouteIsValid() && (potentialRoute.departingStation.GetDepartureTime() == twentyFourTime ||
+            potentialRoute.departingStation.GetDepartureTime() == twentyFourTime - 1200))
+            {
+                potentialRouteList.push_back(std::move(potentialRoute));
+            }
+        }
+    }
+
+    if (potentialRouteList.size() > 0)
+    {
+        //Determine which route is shortest and return it.
+        int minimumWeight = Utility::INF;
+        int shortestRouteIndex = -1;
+        for (int i = 0; i < potentialRouteList.size(); i++)
+        {
+            int totalCurrentWeight = RouteWeight<LayoverMetric>(potentialRouteList[i]);
+
+            if (totalCurrentWeight < minimumWeight)
+            {
+                minimumWeight = totalCurrentWeight;
+                totalCurrentWeight = 0;
+                shortestRouteIndex = i;
+            }
+        }
+
+        return potentialRouteList[shortestRouteIndex];
+    }
+    else
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+}
+
+template<class Metric>
+SequenceTable* StationGraph::floyd_warshal_shortest_paths()
+{
+    // number of table entries will be the larger of station count and size of graph list.
+    const int INF = Utility::INF;
+    // Construct adjacency matrix from adjacencyList. If value == INF, no path exists between start and end index.
+    std::vector<std::vector<int>> distance(departureGraphList->size(), std::vector<int>(departureGraphList->size(), INF));
+    // Sequence table to store shortest paths for future operations.
+    SequenceTable* shortestRouteTable = new SequenceTable(departureGraphList->size(), INF);
+
+    for (int i = 0; i < departureGraphList->size(); i++)
+    {
+        Departure currentDeparture = (*departureGraphList)[i];
+    
+        for (int j = 0; j < currentDeparture.GetTripCount(); j++)
+        {
+            int startID = currentDeparture.GetLookUpKey();
+            int tripWeight = Metric::Weight(currentDeparture.GetTrip(j));
+            int destinationID = currentDeparture.GetTrip(j).destinationKey;
+
+            distance[startID][destinationID] = tripWeight;
+            shortestRouteTable->Row(startID)[destinationID] = destinationID;
+        }
+    }
+
+    //Floyd Warshal Algorithm. Only the order of k decides between equally short paths, it runs in record order.
+    for (int recordIndex = 0; recordIndex < departureGraphList->size(); recordIndex++)
+    {
+        if(stopTableBuild)
+        {
+            delete shortestRouteTable;
+            return nullptr;
+        }
+
+        int k = searchIndexes->departureKeyTable[recordIndex];
+        for (int i = 0; i < departureGraphList->size(); i++)
+        {
+            for (int j = 0; j < departureGraphList->size(); j++)
+            {
+                if (distance[i][k] != INF && distance[k][j] != INF &&
+                    distance[i][k] + distance[k][j] < distance[i][j])
+                {
+                    distance[i][j] = distance[i][k] + distance[k][j];                    
+                    // Update shortest path table to reflect new shorter node.
+                    shortestRouteTable->Row(i)[j] = (*shortestRouteTable)[i][k];
+                }
+            }
+        }
+    }
+
+    return shortestRouteTable;
+}
+
+bool StationGraph::TablesReady() const
+{
+    return tablesReady.load(std::memory_order_acquire);
+}
+
+void StationGraph::WaitForTables()
+{
+    std::lock_guard<std::mutex> lock(tableThreadMutex);
+    if(tableThread.joinable())
+    {
+        tableThread.join();
+    }
+}
+
+Route StationGraph::GetShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers, const QueryDeadline* deadline)
+{
+    if(!TablesReady())
+    {
+        return GetConstrainedRoute(departureStationID, destinationStationID, RouteConstraints(), includeLayovers, deadline);
+    }
+
+    if (includeLayovers)
+    {
+        return get_shortest_route<LayoverMetric>(departureStationID, destinationStationID, *shortestRouteWithLayoverSequenceTable, deadline);
+    }
+    else
+    {
+        return get_shortest_route<RideTimeMetric>(departureStationID, destinationStationID, *shortestRouteWithoutLayoverSequenceTable, deadline);
+    }
+}
+
+Route StationGraph::GetRouteFromTime(int twentyFourTime, int departureStationID, int destinationStationID, const QueryDeadline* deadline)
+{    
+    if(!TablesReady())
+    {
+        return search_route_from_time(departureStationID, destinationStationID, twentyFourTime, deadline);
+    }
+
+    return get_shortest_route_from_time(departureStationID, destinationStationID, twentyFourTime, deadline);
+}
+
+int StationGraph::GetVertexCount()
+{
+    return stationCount;
+}
+
+Station StationGraph::GetStationFromGraph(int stationID)
+{
+    if (stationID >= 1 && stationID <= stationCount)
+    {
+        return Station(stationID, station_timetable().StationDepartures(stationID));
+    }
+    else
+    {
+        // return invalid station if bad station ID
+        return Station({-1, {}});
+    }
+}
+
+const RoutePatternTable& StationGraph::station_timetable() const
+{
+    const StationGraph* graph = this;
+    while(!graph->routePatternTable)
+    {
+        graph = graph->baseGraph;
+    }
+    return *graph->routePatternTable;
+}
+
+Departure StationGraph::GetDepartureFromGraph(int lookUpKey)
+{
+    return (*departureGraphList)[lookUpKey];
+}
+
+int StationGraph::GetDepartureKeyFromRecord(int recordIndex)
+{
+    if(recordIndex < 0 || recordIndex >= searchIndexes->departureKeyTable.size())
+    {
+        return -1;
+    }
+
+    return searchIndexes->departureKeyTable[recordIndex];
+}
+
+int StationGraph::GetRecordIndex(int departureKey)
+{
+    if(departureKey < 0 || departureKey >= searchIndexes->recordIndexTable.size())
+    {
+        return -1;
+    }
+
+    return searchIndexes->recordIndexTable[departureKey];
+}
+
+Station StationGraph::GetStationFromArrivalGraph(int stationID)
+{
+    if (stationID >= 1 && stationID <= stationCount)
+    {
+        return Station(stationID, station_timetable().StationArrivals(stationID));
+    }
+    else
+    {
+        // return invalid station if bad station ID
+        return Station({-1, {}});
+    }
+}
+
+bool StationGraph::PathExists(int startStationID, int targetStationID, const QueryDeadline* deadline, RouteStatus* status)
+{
+    Route shortestRoute = TablesReady()
+        ? get_shortest_route<LayoverMetric>(startStationID, targetStationID, *shortestRouteWithLayoverSequenceTable, deadline)
+        : GetShortestRoute(startStationID, targetStationID, true, deadline);
+    if(status) *status = shortestRoute.status;
+    return shortestRoute.RouteIsValid();
+}
+
+bool StationGraph::DirectPathExists(int startStationID, int targetStationID, const QueryDeadline* deadline, RouteStatus* status)
+{
+    if(status) *status = RouteStatus::Complete;
+    // Without tables this is one scan of the origin's departures, too short to need the deadline.
+    if(!TablesReady())
+    {
+        return direct_departure_exists(startStationID, targetStationID);
+    }
+
+    return direct_route_exists(startStationID, targetStationID, *shortestRouteWithLayoverSequenceTable, deadline, status);
+}
@@ -1,11 +1,27 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include <queue>
 #include <string>
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "utility.hpp"
 #include "station.hpp"
 #include "departure.hpp"
+#include "departure_block_list.hpp"
 #include "route.hpp"
+#include "metric_policy.hpp"
+#include "sequence_table.hpp"
+#include "graph_image.hpp"
+#include "route_constraints.hpp"
+#include "query_deadline.hpp"
+#include "hub_label_index.hpp"
+#include "route_pattern_table.hpp"
+#include "closure_impact.hpp"
+#include "betweenness_scores.hpp"
+#include "work_stealing_pool.hpp"
 
 /*
     Station graph has a few parts, all graphs are pre-computed as adjacency lists, but then converted to adjacency matrix format for
@@ -23,494 +39,213 @@
 
 class StationGraph{
     public:
-        StationGraph(std::vector<std::vector<std::string>> const tripData, std::vector<std::vector<std::string>> const stationData, int stationsCount);
+        // Frequency services are expanded into one vertex per run for the departure graph and everything built on it,
+        // only the route pattern table keeps them as services. With precomputeInBackground the constructor returns once the departure graph and search
+        // indexes are built, and the sequence tables and hub labels are built on a background thread. Until they are ready
+        // every query runs on the on-demand engines, the same as in a scenario, see TablesReady.
+        StationGraph(std::vector<std::vector<std::string>> const tripData, std::vector<std::vector<std::string>> const stationData, int stationsCount,
+            const std::vector<FrequencyService>& frequencyServices = {}, bool precomputeInBackground = false);
+        // Attach to a mapped graph image. Sequence tables are read in place, image must outlive the graph.
+        StationGraph(const GraphImage& image);
+        // Stops a background table build that hasn't finished, the tables it was building are dropped.
         ~StationGraph();
-        bool DirectPathExists(int station1ID, int station2ID);
-        bool PathExists(int startStationID, int targetStationID);        
+        // Whether queries are answered from the sequence tables and hub labels. Once true it stays true, scenarios never have tables.
+        bool TablesReady() const;
+        // Blocks until a background table build has finished. Returns immediately if there is none.
+        void WaitForTables();
+        // The existence, arrival and matrix queries below take an optional deadline too. One that runs past it gives up
+        // and answers as if there were no route (false or Utility::INF), and sets status, when given, to
+        // RouteStatus::TimedOut. An answer found in time sets it to Complete, even if the deadline has passed since.
+        bool DirectPathExists(int station1ID, int station2ID, const QueryDeadline* deadline = nullptr, RouteStatus* status = nullptr);
+        bool PathExists(int startStationID, int targetStationID, const QueryDeadline* deadline = nullptr, RouteStatus* status = nullptr);
+        // Trains leaving the station by departure time, read out of the route pattern table. An invalid station for a bad id.
         Station GetStationFromGraph(int stationID);
+        // Departure keys are positions in the built graph, numbered by station and time. Records are numbered in
+        // trains.dat order (frequency runs after the listed trains), followed by one terminal per station.
         Departure GetDepartureFromGraph(int lookupKey);
-        Route GetShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers);
-        Route GetRouteFromTime(int twentyFourTime, int departureStationID, int destinationStationID);
+        int GetDepartureKeyFromRecord(int recordIndex);
+        int GetRecordIndex(int departureKey);
+        // Routing queries take an optional deadline, see query_deadline.hpp. A query that runs past it returns an
+        // invalid route with status RouteStatus::TimedOut.
+        Route GetShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers, const QueryDeadline* deadline = nullptr);
+        Route GetRouteFromTime(int twentyFourTime, int departureStationID, int destinationStationID, const QueryDeadline* deadline = nullptr);
+        // Trains arriving at the station by arrival time, see RoutePatternTable::StationArrivals.
         Station GetStationFromArrivalGraph(int stationID);
+        // Anytime GetShortestRoute for latency budgets. Trains out of the origin are tried earliest first and the best
+        // journey so far is kept, so when the deadline passes there is usually already a good answer. That answer is
+        // returned with status RouteStatus::Unproven, or TimedOut if nothing was found yet. Complete means every
+        // train was tried and the route is optimal.
+        Route GetAnytimeShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers, const QueryDeadline& deadline);
+        // Earliest arrival (HHMM) at every station leaving departureStationID at or after twentyFourTime, indexed by
+        // station id - 1. Stations that can't be reached within budgetMins of the start time are Utility::INF.
+        // Answered by scanning route patterns, see RoutePatternTable.
+        std::vector<int> GetEarliestArrivals(int departureStationID, int twentyFourTime, int budgetMins = Utility::INF,
+            const QueryDeadline* deadline = nullptr, RouteStatus* status = nullptr);
+        // Route that leaves departureStationID as late as possible and still arrives at destinationStationID by
+        // arriveByTime. Among routes with that departure, the one arriving earliest is returned.
+        Route GetLatestDepartureRoute(int arriveByTime, int departureStationID, int destinationStationID, const QueryDeadline* deadline = nullptr);
+        // Shortest route that changes trains at each via station in order and never uses an avoided station or trip.
+        Route GetConstrainedRoute(int departureStationID, int destinationStationID, const RouteConstraints& constraints, bool includeLayovers,
+            const QueryDeadline* deadline = nullptr);
+        // Departure key of the train leaving stationID at twentyFourTime for destinationStationID, or -1 if there is none
+        // (or it was cancelled).
+        int FindDepartureKey(int stationID, int twentyFourTime, int destinationStationID);
+        // Shortest route from any of departureStationIDs to any of destinationStationIDs, the best GetShortestRoute over
+        // every pair but answered by a single search.
+        Route GetGroupShortestRoute(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs, bool includeLayovers,
+            const QueryDeadline* deadline = nullptr);
+        // Dense departureStationIDs.size() x destinationStationIDs.size() matrix, row-major, holding the weight
+        // GetShortestRoute would report for each pair, Utility::INF where there is no route. One search per origin,
+        // run on a work stealing pool of threadCount threads (0 uses one per hardware thread). No Route objects are built.
+        // Rows whose search gave up at the deadline are left Utility::INF.
+        // The batch APIs fill metrics, when given, with the pool's counters for the batch.
+        std::vector<int> GetTravelTimeMatrix(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+            bool includeLayovers, int threadCount = 0, PoolMetrics* metrics = nullptr, const QueryDeadline* deadline = nullptr,
+            RouteStatus* status = nullptr);
+        // Earliest arrival (HHMM) at destinationStationID for a rider on the departure with departureKey, Utility::INF
+        // if it can't get there. Answered from the hub label index without searching once TablesReady, by a search before.
+        int GetEarliestArrivalFromDeparture(int departureKey, int destinationStationID, const QueryDeadline* deadline = nullptr,
+            RouteStatus* status = nullptr);
+        bool DepartureReachesStation(int departureKey, int destinationStationID);
+        size_t GetHubLabelEntryCount();
+        int GetRoutePatternCount();
+        int GetFrequencyServiceCount();
         int GetVertexCount();
+        // Close every station (or every train when closeTrips is set) in turn and measure the pairs it disconnects and
+        // the minutes it adds to the rest, most disruptive first. Only origins whose shortest paths ran through the
+        // closure are searched again, with the closure as an avoid mask, and closures run on a work stealing pool of
+        // threadCount threads (0 uses one per hardware thread).
+        std::vector<ClosureImpact> GetClosureImpacts(bool closeTrips, int threadCount = 0, PoolMetrics* metrics = nullptr);
+        // Station and train betweenness over the shortest journeys from every departure to every station, Brandes'
+        // algorithm on the departure graph with one forward and one backward sweep per origin departure. Origins are
+        // spread over threadCount threads (0 uses one per hardware thread).
+        BetweennessScores GetBetweenness(int threadCount = 0, PoolMetrics* metrics = nullptr);
+        // Scenario graph for what-if edits. It shares this graph's stations, search indexes and departure blocks, and
+        // an edit copies only the departure blocks it touches. Scenarios have no sequence tables, hub labels or route
+        // patterns, so every query runs on the on-demand engines. The graph a scenario is forked from must outlive it.
+        StationGraph* Fork();
+        // Cancel a departure in a scenario, it can no longer be boarded or connected to. Returns false on a built graph,
+        // whose precomputed tables would go stale, or if departureKey is not a boardable departure.
+        bool CancelDeparture(int departureKey);
+        bool IsScenario();
+        int GetDepartureBlockCount();
+        // Departure blocks this graph copied from the graph it was forked from.
+        int GetCopiedDepartureBlockCount();
     private:
-        const int stationCount;
+        // Graph image serializes the private graph lists and sequence tables directly.
+        friend class GraphImage;
 
-        // Station graph is a simple graph representing connections between stations by train routes.
-        // this is used for easy schedule lookup, not used for route calculations.
-        std::vector<Station>* stationsGraphList;
-        // Arrivals graph is used in partnership with stations graph, it is inverted so that it maps trains arriving at a given station (vertex)
-        // rather than leaving a given station. Used for printing schedules.
-        std::vector<Station>* stationArrivalsGraphList;
+        const int stationCount;
+        // Graph this scenario was forked from, nullptr for built graphs. The route pattern table belongs to the first
+        // built graph in the chain.
+        const StationGraph* baseGraph;
+        // Fork constructor, see Fork.
+        StationGraph(const StationGraph* forkedFrom);
+
+        // Trips grouped by station pair with contiguous timetables, used by the pattern scanning engines and for the
+        // station departure and arrival listings. nullptr in scenarios.
+        RoutePatternTable* routePatternTable;
+        // Pattern table of the first built graph in the chain, station listings don't change in a scenario.
+        const RoutePatternTable& station_timetable() const;
 
         // Departure graph is used for the bulk of our calculations. It represents all possible valid routes by mapping
-        // departure times to the vertices and possible routes to the edges.
-        std::vector<Departure>* departureGraphList;
-        std::vector<std::vector<int>>* shortestRouteWithLayoverSequenceTable;
-        std::vector<std::vector<int>>* shortestRouteWithoutLayoverSequenceTable;
-        void floyd_warshal_shortest_paths(bool includeLayovers);
-        Route get_route(int departureKey, int destinationKey, const std::vector<std::vector<int>>& routeLookUpTable);
-        Route get_shortest_route(int departureID, int destinationID, const std::vector<std::vector<int>> &routeLookUpTable, bool includeLayovers);
-        Route get_shortest_route_from_time(int departureID, int destinationID, int twentyFourTime);
-        bool direct_route_exists(int departureID, int destinationID, const std::vector<std::vector<int>>& routeLookUpTable);
+        // departure times to the vertices and possible routes to the edges. Blocks are shared copy-on-write with forks.
+        DepartureBlockList* departureGraphList;
+        SequenceTable* shortestRouteWithLayoverSequenceTable;
+        SequenceTable* shortestRouteWithoutLayoverSequenceTable;
+        // The table and hub label pointers are only read once tablesReady is set, which the background build does after
+        // assigning all three.
+        std::atomic<bool> tablesReady;
+        std::atomic<bool> stopTableBuild;
+        std::thread tableThread;
+        // Serializes joining tableThread between WaitForTables callers and the destructor.
+        std::mutex tableThreadMutex;
+        void build_sequence_tables();
+
+        // Indexes for the on-demand search engines (station_graph_search.cpp). Departure keys of every non-terminal
+        // vertex sorted by departure time, the same per station (by station id - 1), and each station's terminal key.
+        // Edges always lead to a later departure, so departure time order is a topological order of the graph.
+        // Keyed counterpart of RoutePatternTable::StationArrivals, departure keys of the trains arriving at each station sorted by
+        // arrival time, plus the reverse edges of the departure graph for searches that run backwards in time.
+        // Vertices are numbered by station and time (see build_departures_graph), recordIndexTable and departureKeyTable
+        // translate between departure keys and record indexes, and stationVertexIndex lists every vertex of a station,
+        // terminal included, in record order. Loops that break ties by taking the first candidate walk record order so
+        // the numbering never changes which of several equal routes is returned.
+        // Shared with forked scenarios, cancelling a departure leaves its keys here and the engines skip it.
+        struct SearchIndexes {
+            std::vector<int> departureTimeOrder;
+            std::vector<std::vector<int>> stationDepartureIndex;
+            std::vector<int> terminalKeyTable;
+            std::vector<std::vector<int>> stationArrivalIndex;
+            std::vector<std::vector<int>> predecessorTable;
+            std::vector<int> recordIndexTable;
+            std::vector<int> departureKeyTable;
+            std::vector<std::vector<int>> stationVertexIndex;
+        };
+        std::shared_ptr<const SearchIndexes> searchIndexes;
+        // recordIndexTable is indexed by departure key.
+        void build_search_indexes(const std::vector<int>& recordIndexTable);
+        // 2-hop labels over the departure graph for constant work reachability and earliest arrival lookups.
+        HubLabelIndex* hubLabelIndex;
+        // Minimum weight from any departure at the station to every vertex, by relaxing in departure time order.
+        // Returns false if monitor expired before the sweep finished.
+        template<class Metric> bool shortest_weights_from_station(int departureStationID, std::vector<int>& distance, DeadlineMonitor* monitor = nullptr);
+        // Layover weight to every station's terminal (by station id - 1) leaving departureStationID under constraints.
+        // usedKeys, when given, receives every vertex on those shortest paths.
+        void closure_weights_from_station(int departureStationID, const RouteConstraints& constraints, std::vector<int>& stationWeights,
+            std::vector<int>* usedKeys);
+        // Adds originKey's share of GetBetweenness to the scores, returns the number of stations it reaches.
+        int accumulate_betweenness(int originKey, std::vector<double>& stationScores, std::vector<double>& departureScores);
+        // Returns false if the row's search gave up at the deadline.
+        template<class Metric> bool fill_travel_time_row(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+            int row, std::vector<int>& distance, std::vector<int>& matrix, const QueryDeadline* deadline);
+        int arrival_time(const Departure& departure) const;
+        int destination_station(const Departure& departure) const;
+        std::vector<int>::const_iterator sweep_start(int twentyFourTime) const;
+        Route build_route_from_successors(int departureKey, const std::vector<int>& successor) const;
+        Route build_route_from_path(const std::vector<int>& pathKeys) const;
+        bool vertex_blocked(int departureKey, const RouteConstraints& constraints) const;
+        // Sweeps in departure time order prefetch this many vertices ahead, see prefetch_sweep.
+        static const int SweepPrefetchDistance = 4;
+        // Prefetches the state entry and departure of the vertex SweepPrefetchDistance places after it, and the edges
+        // of the vertex half way there, whose departure an earlier call started loading.
+        template<class T> void prefetch_sweep(std::vector<int>::const_iterator it, const std::vector<T>& state) const;
+        // Returns false if monitor expired before the sweep finished.
+        template<class Metric> bool relax_in_time_order(int startTime, std::vector<int>& distance, std::vector<int>& parent, const RouteConstraints& constraints,
+            DeadlineMonitor* monitor = nullptr);
+        // originKeys replaces the departures boarded at the origin when given.
+        template<class Metric> Route get_constrained_route(int departureStationID, int destinationStationID, const RouteConstraints& constraints,
+            const std::vector<int>* originKeys = nullptr, const QueryDeadline* deadline = nullptr);
+        // On-demand stand-ins for the table and index backed queries, used by scenarios.
+        Route search_route_from_time(int departureID, int destinationID, int twentyFourTime, const QueryDeadline* deadline);
+        bool direct_departure_exists(int departureID, int destinationID);
+        std::vector<int> sweep_earliest_arrivals(int departureStationID, int twentyFourTime, int budgetMins, const QueryDeadline* deadline,
+            RouteStatus* status);
+        int search_earliest_arrival_from_departure(int departureKey, int destinationKey, const QueryDeadline* deadline, RouteStatus* status);
+        // routeLookUpTable is the metric's sequence table, or nullptr to search from each train on demand.
+        template<class Metric> Route get_anytime_shortest_route(int departureStationID, int destinationStationID, const SequenceTable* routeLookUpTable,
+            const QueryDeadline& deadline);
+        template<class Metric> Route get_group_shortest_route(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+            const QueryDeadline* deadline);
+        // Kernels are compiled once per metric policy, see metric_policy.hpp. Returns nullptr if stopTableBuild is set
+        // part way through.
+        template<class Metric> SequenceTable* floyd_warshal_shortest_paths();
+        Route get_route(int departureKey, int destinationKey, const SequenceTable& routeLookUpTable);
+        // get_route to each of destinationKeys, walking RouteWalkBatch paths in lockstep so their table misses overlap.
+        void get_routes(int departureKey, const std::vector<int>& destinationKeys, const SequenceTable& routeLookUpTable,
+            std::vector<Route>& routes);
+        static const int RouteWalkBatch = 8;
+        // One hop of a next-hop walk towards destinationKey, appending the edge taken to path. Returns false once the
+        // walk has ended. The next hop's table entry is prefetched before this vertex's edges are searched.
+        bool advance_route_walk(int& currentKey, int destinationKey, const SequenceTable& routeLookUpTable, std::vector<TripPlusLayover>& path);
+        // Takes the path, which is left empty.
+        Route walked_route(int departureKey, std::vector<TripPlusLayover>& path);
+        template<class Metric> Route get_shortest_route(int departureID, int destinationID, const SequenceTable& routeLookUpTable, const QueryDeadline* deadline);
+        Route get_shortest_route_from_time(int departureID, int destinationID, int twentyFourTime, const QueryDeadline* deadline);
+        bool direct_route_exists(int departureID, int destinationID, const SequenceTable& routeLookUpTable, const QueryDeadline* deadline,
+            RouteStatus* status);
         bool station_records_match(int Key1, int Key2, const std::vector<std::vector<std::string>>& tripDataTable);
-        void build_stations_graph(std::vector<std::vector<std::string>> tripData);
-        void build_station_arrivals_graph(std::vector<std::vector<std::string>> tripData);
-        void build_departures_graph(std::vector<std::vector<std::string>> tripData, std::vector<std::vector<std::string>> stationData);
+        // Fills recordIndexTable with the record index of each departure key.
+        void build_departures_graph(std::vector<std::vector<std::string>> tripData, std::vector<std::vector<std::string>> stationData,
+            std::vector<int>& recordIndexTable);
 };
-
-StationGraph::StationGraph(std::vector<std::vector<std::string>> const tripDataTable, std::vector<std::vector<std::string>> const stationDataTable, int stationsCount) : stationCount(stationsCount)
-{
-    build_stations_graph(tripDataTable);
-    build_station_arrivals_graph(tripDataTable);
-    build_departures_graph(tripDataTable, stationDataTable);
-
-    // Build shortest path lookup table for both including layovers, and for not including layvoers.
-    floyd_warshal_shortest_paths(true);
-    floyd_warshal_shortest_paths(false);
-}
-
-StationGraph::~StationGraph()
-{
-    if(stationsGraphList) delete stationsGraphList;
-    if(stationArrivalsGraphList) delete stationArrivalsGraphList;
-    if(departureGraphList) delete departureGraphList;
-    if(shortestRouteWithLayoverSequenceTable) delete shortestRouteWithLayoverSequenceTable;
-    if(shortestRouteWithoutLayoverSequenceTable) delete shortestRouteWithoutLayoverSequenceTable;
-}
-
-void StationGraph::build_stations_graph(std::vector<std::vector<std::string>> tripDataTable)
-{
-    // Use a temporary table to hold all trips so that they
-    // can be passed into station constructor.
-    // We don't want to allow the addition of new graph elements after construction because we are pre-computing shortest paths
-    // so not making any public functions to add nodes or edges.
-    stationsGraphList = new std::vector<Station>;
-
-    std::vector<std::vector<Trip>> tempTripTable;
-    for(int i = 0; i < stationCount; i++)
-    {
-        tempTripTable.push_back({});
-    }
-
-    //Add the trip data to tempTripTable array
-    for(int i = 0; i < tripDataTable.size(); i++)
-    {
-        int startID = stoi(tripDataTable[i][0]) - 1;
-        int destinationID = stoi(tripDataTable[i][1]);
-        int arrivalTime = stoi(tripDataTable[i][3]);
-        int departureTime = stoi(tripDataTable[i][2]);
-        tempTripTable[startID].push_back({destinationID, departureTime, arrivalTime});
-    }
-
-    //Construct the stations and add trips to graph.
-    for(int i = 0; i < stationCount; i++)
-    {
-        stationsGraphList->push_back({i + 1, tempTripTable[i]});
-    }
-}
-
-bool StationGraph::station_records_match(int Key1, int Key2, const std::vector<std::vector<std::string>>& tripDataTable)
-{
-    return (stoi(tripDataTable[Key1][0]) == stoi(tripDataTable[Key2][0])
-        && stoi(tripDataTable[Key1][1]) == stoi(tripDataTable[Key2][1])
-        && stoi(tripDataTable[Key1][2]) == stoi(tripDataTable[Key2][2])
-        && stoi(tripDataTable[Key1][3]) == stoi(tripDataTable[Key2][3]));
-}
-
-void StationGraph::build_departures_graph(std::vector<std::vector<std::string>> tripDataTable, std::vector<std::vector<std::string>> stationDataTable)
-{
-    departureGraphList = new std::vector<Departure>;
-    std::vector<std::pair<std::pair<int, int>, std::vector<TripPlusLayover>>> tempTripTable; 
-
-    for(int i = 0; i < tripDataTable.size(); i++)
-    {
-        tempTripTable.push_back({});
-    }
-
-    for(int i = 0; i < tripDataTable.size(); i++)
-    {        
-        int destinationKey;
-        int departureTime = stoi(tripDataTable[i][2]);
-        int rideTimeToDestination = stoi(tripDataTable[i][3]) - stoi(tripDataTable[i][2]);
-        int layoverAtDestination = 0; // this node marks end of trip, no layover added.
-        int totalTripTime = rideTimeToDestination + layoverAtDestination;
-
-        // Map trip target station id to the lookUpKey of the vertex.
-        for(int keyIndx = 0; keyIndx < tripDataTable.size(); keyIndx++)
-        {
-            if(station_records_match(keyIndx, i, tripDataTable))
-            {   
-                // Map terminating destinations to the appropriate keys at the end of the look up table.             
-                destinationKey = stoi(tripDataTable[keyIndx][1]) + (tripDataTable.size() - 1);
-            }
-        }
-
-        for(int k = 0; k < tripDataTable.size(); k++)
-        {
-            //If the target edge departure time and departure station match, this is the correct insertion point, add edge to adjacency list.
-            if(station_records_match(k, i, tripDataTable))
-            {
-                tempTripTable[k].first.first = departureTime;
-                tempTripTable[k].first.second = stoi(tripDataTable[i][0]);
-                tempTripTable[k].second.push_back({destinationKey, rideTimeToDestination, layoverAtDestination, totalTripTime});                
-            }
-        }
-        
-        for(int j = 0; j < tripDataTable.size(); j++)
-        {                        
-            if(j != i && tripDataTable[i][1] == tripDataTable[j][0] && tripDataTable[i][3] < tripDataTable[j][2])
-            {
-                departureTime = stoi(tripDataTable[i][2]);
-                rideTimeToDestination = stoi(tripDataTable[i][3]) - stoi(tripDataTable[i][2]);
-                layoverAtDestination = stoi(tripDataTable[j][2]) - stoi(tripDataTable[i][3]);
-                totalTripTime = rideTimeToDestination + layoverAtDestination;
-
-                // Map trip ID to its corresponding key value for easy look up.
-                for (int keyIndx = 0; keyIndx < tripDataTable.size(); keyIndx++)
-                {
-                    if (station_records_match(keyIndx, j, tripDataTable))
-                    {
-                        destinationKey = keyIndx;
-                    }
-                }
-
-                // Search adjacency list for matching vertex to insert new edge data. Can't be a simple index with current setup.
-                // This is the only time this search must happen because when the graph is created, each departure is assigned a lookupKey that can be used
-                // to index the list and match the vertex.
-                for (int k = 0; k < tripDataTable.size(); k++)
-                {
-                    //If the target edge departure time and departure station match, this is the correct insertion point, add edge to adjacency list.
-                    if (station_records_match(k, i, tripDataTable))
-                    {
-                        tempTripTable[k].first.first = departureTime;
-                        tempTripTable[k].first.second = stoi(tripDataTable[i][0]);
-                        tempTripTable[k].second.push_back({destinationKey, rideTimeToDestination, layoverAtDestination, totalTripTime});
-                    }
-                }
-            }
-        }
-    }
-
-    // Populate the departure graph using data from tempTripTable.
-    for(int i = 0; i < tempTripTable.size(); i++)
-    {
-        departureGraphList->push_back({tempTripTable[i].second, tempTripTable[i].first.second, i, tempTripTable[i].first.first});
-    }
-
-    // Populate terminating arrival nodes, required for shortest path algortithm
-    for(int i = 0; i < stationDataTable.size(); i++)
-    {
-       departureGraphList->push_back({{}, stoi(stationDataTable[i][0]), i + (int)tempTripTable.size(), 0});     
-    }
-}
-
-void StationGraph::build_station_arrivals_graph(std::vector<std::vector<std::string>> tripDataTable)
-{
-    stationArrivalsGraphList = new std::vector<Station>;
-
-    std::vector<std::vector<Trip>> tempTripTable;
-    for(int i = 0; i < stationCount; i++)
-    {
-        tempTripTable.push_back({});
-    }
-
-    //Add the trip data to tempTripTable array
-    for(int i = 0; i < tripDataTable.size(); i++)
-    {
-        int startID = stoi(tripDataTable[i][1]) - 1;
-        int destinationID = stoi(tripDataTable[i][0]);
-        int arrivalTime = stoi(tripDataTable[i][2]);
-        int departureTime = stoi(tripDataTable[i][3]);
-        tempTripTable[startID].push_back({destinationID, departureTime, arrivalTime});
-    }
-
-    //Construct the stations and add trips to graph.
-    for(int i = 0; i < stationCount; i++)
-    {
-        stationArrivalsGraphList->push_back({i + 1, tempTripTable[i]});
-    }
-}
-
-Route StationGraph::get_route(int departureKey, int destinationKey, const std::vector<std::vector<int>>& routeLookUpTable)
-{        
-    std::vector<TripPlusLayover> shortPath;
-    
-    int nextStopID = departureKey;
-    bool endOfPath = false;
-
-    while(!endOfPath)
-    {
-        Departure currentNode = (*departureGraphList)[nextStopID];
-        nextStopID = routeLookUpTable[nextStopID][destinationKey];
-
-        if (currentNode.IsFinalDestination() || nextStopID == Utility::INF)
-        {
-            if(nextStopID != Utility::INF)
-            {
-                shortPath.push_back(currentNode.FindTripByDestinationKey(nextStopID));
-            }
-            endOfPath = true;
-        }
-        else
-        {
-            TripPlusLayover nextTrip = currentNode.FindTripByDestinationKey(nextStopID);
-            shortPath.push_back(nextTrip);
-        }
-    }
-
-    Route finalRoute{(*departureGraphList)[departureKey], shortPath};
-
-    if(finalRoute.RouteIsValid())
-    {        
-        return finalRoute;
-    }
-    else
-    {        
-        return{{{}, -1, -1, -1} ,{}};
-    }            
-}
-bool StationGraph::direct_route_exists(int departureID, int destinationID, const std::vector<std::vector<int>>& routeLookUpTable)
-{
-    std::vector<Route> potentialRouteList;
-
-    for (int j = 0; j < departureGraphList->size(); j++)
-    {
-        for (int k = 0; k < departureGraphList->size(); k++)
-        {
-            if ((*departureGraphList)[j].GetStationID() == departureID && (*departureGraphList)[k].GetStationID() == destinationID)
-            {
-                Route potentialRoute = get_route(j, k, routeLookUpTable);
-                if (potentialRoute.RouteIsValid())
-                {
-                    if(potentialRoute.tripList.size() == 1)
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-
-    return false;
-}
-Route StationGraph::get_shortest_route(int departureID, int destinationID, const std::vector<std::vector<int>> &routeLookUpTable, bool includeLayovers)
-{
-    std::vector<Route> potentialRouteList;
-
-    for (int j = 0; j < departureGraphList->size(); j++)
-    {
-        for (int k = 0; k < departureGraphList->size(); k++)
-        {
-            if ((*departureGraphList)[j].GetStationID() == departureID && (*departureGraphList)[k].GetStationID() == destinationID)
-            {
-                Route potentialRoute = get_route(j, k, routeLookUpTable);
-                if (potentialRoute.RouteIsValid())
-                {
-                    potentialRouteList.push_back(potentialRoute);
-                }
-            }
-        }
-    }
-
-    if (potentialRouteList.size() > 0)
-    {
-        //Determine which route is shortest and return it.
-        int minimumWeight = Utility::INF;
-        int shortestRouteIndex = -1;
-        for (int i = 0; i < potentialRouteList.size(); i++)
-        {
-            int totalCurrentWeight = 0;
-            for (int j = 0; j < potentialRouteList[i].tripList.size(); j++)
-            {
-                TripPlusLayover currentTrip = potentialRouteList[i].tripList[j];
-                totalCurrentWeight += includeLayovers? currentTrip.tripWeight : currentTrip.rideTimeToDestinationMins;
-            }
-
-            if (totalCurrentWeight < minimumWeight)
-            {
-                minimumWeight = totalCurrentWeight;
-                totalCurrentWeight = 0;
-                shortestRouteIndex = i;
-            }
-        }
-
-        return potentialRouteList[shortestRouteIndex];
-    }
-    else
-    {
-        return {{{}, -1, -1, -1}, {}};
-    }
-}
-
-Route StationGraph::get_shortest_route_from_time(int departureID, int destinationID, int twentyFourTime)
-{
-    std::vector<Route> potentialRouteList;
-
-    for (int j = 0; j < departureGraphList->size(); j++)
-    {
-        for (int k = 0; k < departureGraphList->size(); k++)
-        {
-            if ((*departureGraphList)[j].GetStationID() == departureID && (*departureGraphList)[k].GetStationID() == destinationID)
-            {
-                Route potentialRoute = get_route(j, k, *shortestRouteWithLayoverSequenceTable);
-                if (potentialRoute.RouteIsValid() && (potentialRoute.departingStation.GetDepartureTime() == twentyFourTime ||
-                potentialRoute.departingStation.GetDepartureTime() == twentyFourTime - 1200))
-                {
-                    potentialRouteList.push_back(potentialRoute);
-                }
-            }
-        }
-    }
-
-    if (potentialRouteList.size() > 0)
-    {
-        //Determine which route is shortest and return it.
-        int minimumWeight = Utility::INF;
-        int shortestRouteIndex = -1;
-        for (int i = 0; i < potentialRouteList.size(); i++)
-        {
-            int totalCurrentWeight = 0;
-            for (int j = 0; j < potentialRouteList[i].tripList.size(); j++)
-            {
-                TripPlusLayover currentTrip = potentialRouteList[i].tripList[j];
-                totalCurrentWeight += currentTrip.tripWeight;
-            }
-
-            if (totalCurrentWeight < minimumWeight)
-            {
-                minimumWeight = totalCurrentWeight;
-                totalCurrentWeight = 0;
-                shortestRouteIndex = i;
-            }
-        }
-
-        return potentialRouteList[shortestRouteIndex];
-    }
-    else
-    {
-        return {{{}, -1, -1, -1}, {}};
-    }
-}
-
-void StationGraph::floyd_warshal_shortest_paths(bool includeLayovers)
-{
-    // number of table entries will be the larger of station count and size of graph list.
-    const int INF = Utility::INF;
-    // Construct adjacency matrix from adjacencyList. If value == INF, no path exists between start and end index.
-    std::vector<std::vector<int>> distance(departureGraphList->size(), std::vector<int>(departureGraphList->size(), INF));
-    // Sequence table to store shortest paths for future operations.
-    std::vector<std::vector<int>> *shortestRouteTable;
-
-    if (includeLayovers)
-    {
-        shortestRouteWithLayoverSequenceTable = new std::vector<std::vector<int>>(departureGraphList->size(), std::vector<int>(departureGraphList->size(), INF));
-        shortestRouteTable = shortestRouteWithLayoverSequenceTable;
-    }
-    else
-    {
-        shortestRouteWithoutLayoverSequenceTable = new std::vector<std::vector<int>>(departureGraphList->size(), std::vector<int>(departureGraphList->size(), INF));
-        shortestRouteTable = shortestRouteWithoutLayoverSequenceTable;
-    }
-
-    for (int i = 0; i < departureGraphList->size(); i++)
-    {
-        Departure currentDeparture = (*departureGraphList)[i];
-    
-        for (int j = 0; j < currentDeparture.GetTripCount(); j++)
-        {
-            int startID = currentDeparture.GetLookUpKey();
-            // if not include layovers, only include ride time in weight calculation.
-            int tripWeight = includeLayovers? currentDeparture.GetTrip(j).tripWeight : currentDeparture.GetTrip(j).rideTimeToDestinationMins;            
-            int destinationID = currentDeparture.GetTrip(j).destinationKey;
-
-            distance[startID][destinationID] = tripWeight;
-            (*shortestRouteTable)[startID][destinationID] = destinationID;
-        }
-    }
-
-    //Floyd Warshal Algorithm
-    for (int k = 0; k < departureGraphList->size(); k++)
-    {
-        for (int i = 0; i < departureGraphList->size(); i++)
-        {
-            for (int j = 0; j < departureGraphList->size(); j++)
-            {
-                if (distance[i][k] != INF && distance[k][j] != INF &&
-                    distance[i][k] + distance[k][j] < distance[i][j])
-                {
-                    distance[i][j] = distance[i][k] + distance[k][j];                    
-                    // Update shortest path table to reflect new shorter node.
-                    (*shortestRouteTable)[i][j] = (*shortestRouteTable)[i][k];
-                }
-            }
-        }
-    }
-}
-
-Route StationGraph::GetShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers)
-{
-    if (includeLayovers)
-    {
-        return get_shortest_route(departureStationID, destinationStationID, *shortestRouteWithLayoverSequenceTable, true);
-    }
-    else
-    {
-        return get_shortest_route(departureStationID, destinationStationID, *shortestRouteWithoutLayoverSequenceTable, false);
-    }
-}
-
-Route StationGraph::GetRouteFromTime(int twentyFourTime, int departureStationID, int destinationStationID)
-{    
-    return get_shortest_route_from_time(departureStationID, destinationStationID, twentyFourTime);
-}
-
-int StationGraph::GetVertexCount()
-{
-    return stationCount;
-}
-
-Station StationGraph::GetStationFromGraph(int stationID)
-{
-    int iDAsZeroIndex = stationID - 1;
-    if (iDAsZeroIndex < stationsGraphList->size() && iDAsZeroIndex >= 0)
-    {
-        return (*stationsGraphList)[iDAsZeroIndex];
-    }
-    else
-    {
-        // return invalid station if bad station ID
-        return Station({-1, {}});
-    }
-}
-
-Departure StationGraph::GetDepartureFromGraph(int lookUpKey)
-{
-    return (*departureGraphList)[lookUpKey];
-}
-
-// Duplication of code between two graph types. Might want to pull this out to be more
-// generic.
-Station StationGraph::GetStationFromArrivalGraph(int stationID)
-{
-    int iDAsZeroIndex = stationID - 1;
-    if (iDAsZeroIndex < stationArrivalsGraphList->size() && iDAsZeroIndex >= 0)
-    {
-        return (*stationArrivalsGraphList)[iDAsZeroIndex];
-    }
-    else
-    {
-        // return invalid station if bad station ID
-        return Station({-1, {}});
-    }
-}
-
-bool StationGraph::PathExists(int startStationID, int targetStationID)
-{
-    return (get_shortest_route(startStationID, targetStationID, *shortestRouteWithLayoverSequenceTable, true).RouteIsValid());
-}
-
-bool StationGraph::DirectPathExists(int startStationID, int targetStationID)
-{
-    return direct_route_exists(startStationID, targetStationID, *shortestRouteWithLayoverSequenceTable);    
-}
@@ -0,0 +1,1256 @@
+#include <algorithm>
+#include <thread>
+#include <queue>
+#include <functional>
+#include "station_graph.hpp"
+
+/*
+    On-demand search engines over the departure graph. Unlike the sequence table queries these don't need
+    floyd_warshal_shortest_paths, they walk the graph directly using the indexes from build_search_indexes.
+*/
+
+void StationGraph::build_search_indexes(const std::vector<int>& recordIndexTable)
+{
+    std::shared_ptr<SearchIndexes> indexes = std::make_shared<SearchIndexes>();
+    std::vector<int>& departureTimeOrder = indexes->departureTimeOrder;
+    std::vector<std::vector<int>>& stationDepartureIndex = indexes->stationDepartureIndex;
+    std::vector<int>& terminalKeyTable = indexes->terminalKeyTable;
+    std::vector<std::vector<int>>& stationArrivalIndex = indexes->stationArrivalIndex;
+    std::vector<std::vector<int>>& predecessorTable = indexes->predecessorTable;
+    std::vector<int>& departureKeyTable = indexes->departureKeyTable;
+    std::vector<std::vector<int>>& stationVertexIndex = indexes->stationVertexIndex;
+
+    stationDepartureIndex.assign(stationCount, {});
+    terminalKeyTable.assign(stationCount, -1);
+    stationArrivalIndex.assign(stationCount, {});
+    predecessorTable.assign(departureGraphList->size(), {});
+    stationVertexIndex.assign(stationCount, {});
+    indexes->recordIndexTable = recordIndexTable;
+    departureKeyTable.assign(recordIndexTable.size(), -1);
+    for(int key = 0; key < recordIndexTable.size(); key++)
+    {
+        departureKeyTable[recordIndexTable[key]] = key;
+    }
+
+    // Record order, so every list below comes out in the same order whatever the numbering.
+    for(int key : departureKeyTable)
+    {
+        const Departure& departure = (*departureGraphList)[key];
+        int stationIndex = departure.GetStationID() - 1;
+        if(stationIndex < 0 || stationIndex >= stationCount)
+        {
+            continue;
+        }
+
+        stationVertexIndex[stationIndex].push_back(key);
+        if(departure.IsFinalDestination())
+        {
+            terminalKeyTable[stationIndex] = key;
+        }
+        else
+        {
+            departureTimeOrder.push_back(key);
+            stationDepartureIndex[stationIndex].push_back(key);
+            stationArrivalIndex[destination_station(departure) - 1].push_back(key);
+
+            for(int i = 0; i < departure.GetTripCount(); i++)
+            {
+                predecessorTable[departure.GetTrip(i).destinationKey].push_back(key);
+            }
+        }
+    }
+
+    auto departsBefore = [this, &recordIndexTable](int key1, int key2) {
+        int time1 = (*departureGraphList)[key1].GetDepartureTime();
+        int time2 = (*departureGraphList)[key2].GetDepartureTime();
+        return time1 < time2 || (time1 == time2 && recordIndexTable[key1] < recordIndexTable[key2]);
+    };
+    std::sort(departureTimeOrder.begin(), departureTimeOrder.end(), departsBefore);
+    for(std::vector<int>& stationDepartures : stationDepartureIndex)
+    {
+        std::sort(stationDepartures.begin(), stationDepartures.end(), departsBefore);
+    }
+
+    for(std::vector<int>& stationArrivals : stationArrivalIndex)
+    {
+        std::sort(stationArrivals.begin(), stationArrivals.end(), [this](int key1, int key2) {
+            return arrival_time((*departureGraphList)[key1]) < arrival_time((*departureGraphList)[key2]);
+        });
+    }
+    searchIndexes = indexes;
+}
+
+// Every edge of a departure rides the same train, so the first edge gives the arrival time and station.
+int StationGraph::arrival_time(const Departure& departure) const
+{
+    return departure.GetDepartureTime() + departure.GetTrip(0).rideTimeToDestinationMins;
+}
+
+int StationGraph::destination_station(const Departure& departure) const
+{
+    return (*departureGraphList)[departure.GetTrip(0).destinationKey].GetStationID();
+}
+
+// First vertex in departure time order leaving at or after twentyFourTime.
+std::vector<int>::const_iterator StationGraph::sweep_start(int twentyFourTime) const
+{
+    return std::lower_bound(searchIndexes->departureTimeOrder.begin(), searchIndexes->departureTimeOrder.end(), twentyFourTime,
+        [this](int key, int time) { return (*departureGraphList)[key].GetDepartureTime() < time; });
+}
+
+// Time order jumps between stations, so the next few vertices of a sweep are rarely in cache yet.
+template<class T>
+void StationGraph::prefetch_sweep(std::vector<int>::const_iterator it, const std::vector<T>& state) const
+{
+    std::vector<int>::const_iterator end = searchIndexes->departureTimeOrder.end();
+    if(end - it > SweepPrefetchDistance)
+    {
+        int aheadKey = *(it + SweepPrefetchDistance);
+        Utility::Prefetch(&state[aheadKey]);
+        Utility::Prefetch(&(*departureGraphList)[aheadKey]);
+    }
+    if(end - it > SweepPrefetchDistance / 2)
+    {
+        (*departureGraphList)[*(it + SweepPrefetchDistance / 2)].PrefetchTrips();
+    }
+}
+
+// Follow successor links from departureKey to a terminal vertex, collecting the edges the same way get_route does.
+Route StationGraph::build_route_from_successors(int departureKey, const std::vector<int>& successor) const
+{
+    std::vector<TripPlusLayover> shortPath;
+    int currentKey = departureKey;
+    while(currentKey >= 0 && successor[currentKey] >= 0)
+    {
+        shortPath.push_back((*departureGraphList)[currentKey].FindTripByDestinationKey(successor[currentKey]));
+        currentKey = successor[currentKey];
+    }
+
+    Route finalRoute{(*departureGraphList)[departureKey], shortPath};
+    if(finalRoute.RouteIsValid())
+    {
+        return finalRoute;
+    }
+    else
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+}
+
+// pathKeys runs from the boarding vertex to the terminal vertex.
+Route StationGraph::build_route_from_path(const std::vector<int>& pathKeys) const
+{
+    if(pathKeys.size() < 2)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    std::vector<TripPlusLayover> shortPath;
+    for(int i = 0; i + 1 < pathKeys.size(); i++)
+    {
+        shortPath.push_back((*departureGraphList)[pathKeys[i]].FindTripByDestinationKey(pathKeys[i + 1]));
+    }
+
+    Route finalRoute{(*departureGraphList)[pathKeys[0]], shortPath};
+    if(finalRoute.RouteIsValid())
+    {
+        return finalRoute;
+    }
+    else
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+}
+
+std::vector<int> StationGraph::GetEarliestArrivals(int departureStationID, int twentyFourTime, int budgetMins, const QueryDeadline* deadline,
+    RouteStatus* status)
+{
+    if(!routePatternTable)
+    {
+        return sweep_earliest_arrivals(departureStationID, twentyFourTime, budgetMins, deadline, status);
+    }
+
+    return routePatternTable->EarliestArrivals(departureStationID, twentyFourTime, budgetMins, deadline, status);
+}
+
+// Departure graph version of RoutePatternTable::EarliestArrivals, for scenarios.
+std::vector<int> StationGraph::sweep_earliest_arrivals(int departureStationID, int twentyFourTime, int budgetMins, const QueryDeadline* deadline,
+    RouteStatus* status)
+{
+    if(status) *status = RouteStatus::Complete;
+    DeadlineMonitor monitor(deadline);
+    std::vector<int> earliestArrival(stationCount, Utility::INF);
+    if(departureStationID < 1 || departureStationID > stationCount)
+    {
+        return earliestArrival;
+    }
+
+    int startMins = Utility::TwentyFourTimeToMinutes(twentyFourTime);
+    // Trains leaving after the budget runs out can't arrive within it either.
+    int latestUsefulMins = budgetMins == Utility::INF ? Utility::INF : startMins + budgetMins;
+    earliestArrival[departureStationID - 1] = twentyFourTime;
+
+    // Seed every train leaving the origin at or after the start time, then sweep the rest of the day in
+    // departure order. A departure is boarded only if some earlier boarded train connects to it.
+    std::vector<char> reached(departureGraphList->size(), 0);
+    for(int key : searchIndexes->stationDepartureIndex[departureStationID - 1])
+    {
+        if((*departureGraphList)[key].GetDepartureTime() >= twentyFourTime && !(*departureGraphList)[key].IsCancelled())
+        {
+            reached[key] = 1;
+        }
+    }
+
+    for(std::vector<int>::const_iterator it = sweep_start(twentyFourTime); it != searchIndexes->departureTimeOrder.end(); ++it)
+    {
+        prefetch_sweep(it, reached);
+        if(monitor.Expired())
+        {
+            if(status) *status = RouteStatus::TimedOut;
+            return std::vector<int>(stationCount, Utility::INF);
+        }
+
+        const Departure& departure = (*departureGraphList)[*it];
+        if(Utility::TwentyFourTimeToMinutes(departure.GetDepartureTime()) > latestUsefulMins)
+        {
+            break;
+        }
+        if(!reached[*it])
+        {
+            continue;
+        }
+
+        int arrivalTime = arrival_time(departure);
+        if(Utility::TwentyFourTimeToMinutes(arrivalTime) > latestUsefulMins)
+        {
+            continue;
+        }
+
+        int stationIndex = destination_station(departure) - 1;
+        earliestArrival[stationIndex] = std::min(earliestArrival[stationIndex], arrivalTime);
+
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            reached[departure.GetTrip(i).destinationKey] = 1;
+        }
+    }
+
+    return earliestArrival;
+}
+
+template<class Metric>
+bool StationGraph::shortest_weights_from_station(int departureStationID, std::vector<int>& distance, DeadlineMonitor* monitor)
+{
+    std::fill(distance.begin(), distance.end(), Utility::INF);
+
+    const std::vector<int>& originDepartures = searchIndexes->stationDepartureIndex[departureStationID - 1];
+    if(originDepartures.size() == 0)
+    {
+        return true;
+    }
+
+    for(int key : originDepartures)
+    {
+        if(!(*departureGraphList)[key].IsCancelled())
+        {
+            distance[key] = 0;
+        }
+    }
+
+    // Nothing before the first train out of the origin can be reached.
+    for(std::vector<int>::const_iterator it = sweep_start((*departureGraphList)[originDepartures[0]].GetDepartureTime()); it != searchIndexes->departureTimeOrder.end(); ++it)
+    {
+        prefetch_sweep(it, distance);
+        if(monitor && monitor->Expired())
+        {
+            return false;
+        }
+
+        int currentDistance = distance[*it];
+        if(currentDistance == Utility::INF)
+        {
+            continue;
+        }
+
+        const Departure& departure = (*departureGraphList)[*it];
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            const TripPlusLayover& trip = departure.GetTrip(i);
+            int newDistance = currentDistance + Metric::Weight(trip);
+            if(newDistance < distance[trip.destinationKey])
+            {
+                distance[trip.destinationKey] = newDistance;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<class Metric>
+bool StationGraph::fill_travel_time_row(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+    int row, std::vector<int>& distance, std::vector<int>& matrix, const QueryDeadline* deadline)
+{
+    // Each row is its own search, rows that start after the deadline give up straight away.
+    DeadlineMonitor monitor(deadline);
+    int departureStationID = departureStationIDs[row];
+    bool validOrigin = departureStationID >= 1 && departureStationID <= stationCount;
+    if(validOrigin && ((deadline && deadline->Expired()) || !shortest_weights_from_station<Metric>(departureStationID, distance, &monitor)))
+    {
+        return false;
+    }
+
+    for(int column = 0; column < destinationStationIDs.size(); column++)
+    {
+        int destinationStationID = destinationStationIDs[column];
+        int weight = Utility::INF;
+        if(validOrigin && destinationStationID >= 1 && destinationStationID <= stationCount && searchIndexes->terminalKeyTable[destinationStationID - 1] >= 0)
+        {
+            // Stopping at the terminal is never heavier than arriving and waiting for another train there.
+            weight = distance[searchIndexes->terminalKeyTable[destinationStationID - 1]];
+        }
+        matrix[(size_t)row * destinationStationIDs.size() + column] = weight;
+    }
+    return true;
+}
+
+std::vector<int> StationGraph::GetTravelTimeMatrix(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+    bool includeLayovers, int threadCount, PoolMetrics* metrics, const QueryDeadline* deadline, RouteStatus* status)
+{
+    std::vector<int> matrix(departureStationIDs.size() * destinationStationIDs.size(), Utility::INF);
+
+    if(threadCount <= 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    WorkStealingPool pool(std::min(threadCount, std::max(1, (int)departureStationIDs.size())));
+
+    // A hub origin's search can cost many times a leaf's, rows are split across workers as they go idle.
+    std::vector<std::vector<int>> distance(pool.GetThreadCount(), std::vector<int>(departureGraphList->size()));
+    std::atomic<bool> timedOut(false);
+    pool.ParallelFor(0, departureStationIDs.size(), [&](int row, int workerIndex) {
+        bool rowFilled = includeLayovers
+            ? fill_travel_time_row<LayoverMetric>(departureStationIDs, destinationStationIDs, row, distance[workerIndex], matrix, deadline)
+            : fill_travel_time_row<RideTimeMetric>(departureStationIDs, destinationStationIDs, row, distance[workerIndex], matrix, deadline);
+        if(!rowFilled)
+        {
+            timedOut.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    if(metrics)
+    {
+        *metrics = pool.GetMetrics();
+    }
+    if(status)
+    {
+        *status = timedOut.load() ? RouteStatus::TimedOut : RouteStatus::Complete;
+    }
+    return matrix;
+}
+
+Route StationGraph::GetLatestDepartureRoute(int arriveByTime, int departureStationID, int destinationStationID, const QueryDeadline* deadline)
+{
+    if(departureStationID < 1 || departureStationID > stationCount || destinationStationID < 1 || destinationStationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    // bestArrival is the earliest arrival at the destination reachable by boarding a vertex, successor is the
+    // next vertex on that path (the destination terminal for trains that arrive there directly).
+    std::vector<int> bestArrival(departureGraphList->size(), Utility::INF);
+    std::vector<int> successor(departureGraphList->size(), -1);
+
+    // Seed with the trains arriving at the destination in time, taken from the arrivals index.
+    for(int key : searchIndexes->stationArrivalIndex[destinationStationID - 1])
+    {
+        int arrivalTime = arrival_time((*departureGraphList)[key]);
+        if(arrivalTime > arriveByTime)
+        {
+            break;
+        }
+        if((*departureGraphList)[key].IsCancelled())
+        {
+            continue;
+        }
+        bestArrival[key] = arrivalTime;
+        successor[key] = searchIndexes->terminalKeyTable[destinationStationID - 1];
+    }
+
+    // Sweep backwards in departure time pushing each reached vertex to the trains that connect into it.
+    // Every successor departs later, so a vertex is final when the sweep reaches it and the first reached
+    // vertex at the origin is the latest possible departure.
+    std::vector<int>::const_iterator sweepEnd = std::upper_bound(searchIndexes->departureTimeOrder.begin(), searchIndexes->departureTimeOrder.end(), arriveByTime,
+        [this](int time, int key) { return time < (*departureGraphList)[key].GetDepartureTime(); });
+
+    int latestKey = -1;
+    DeadlineMonitor monitor(deadline);
+    for(std::vector<int>::const_iterator it = sweepEnd; it != searchIndexes->departureTimeOrder.begin();)
+    {
+        if(monitor.Expired())
+        {
+            return {{{}, -1, -1, -1}, {}, RouteStatus::TimedOut};
+        }
+
+        --it;
+        int key = *it;
+        const Departure& departure = (*departureGraphList)[key];
+
+        // Trains leaving at the same time can't connect to each other, so once the latest departure is found
+        // only the rest of that minute needs checking for an earlier arrival.
+        if(latestKey >= 0 && departure.GetDepartureTime() != (*departureGraphList)[latestKey].GetDepartureTime())
+        {
+            break;
+        }
+        if(bestArrival[key] == Utility::INF || departure.IsCancelled())
+        {
+            continue;
+        }
+
+        if(departure.GetStationID() == departureStationID)
+        {
+            if(latestKey < 0 || bestArrival[key] < bestArrival[latestKey])
+            {
+                latestKey = key;
+            }
+            continue;
+        }
+
+        for(int predecessorKey : searchIndexes->predecessorTable[key])
+        {
+            if(bestArrival[key] < bestArrival[predecessorKey])
+            {
+                bestArrival[predecessorKey] = bestArrival[key];
+                successor[predecessorKey] = key;
+            }
+        }
+    }
+
+    if(latestKey >= 0)
+    {
+        return build_route_from_successors(latestKey, successor);
+    }
+
+    return {{{}, -1, -1, -1}, {}};
+}
+
+int StationGraph::FindDepartureKey(int stationID, int twentyFourTime, int destinationStationID)
+{
+    if(stationID < 1 || stationID > stationCount)
+    {
+        return -1;
+    }
+
+    for(int key : searchIndexes->stationDepartureIndex[stationID - 1])
+    {
+        const Departure& departure = (*departureGraphList)[key];
+        if(departure.GetDepartureTime() == twentyFourTime && destination_station(departure) == destinationStationID && !departure.IsCancelled())
+        {
+            return key;
+        }
+    }
+
+    return -1;
+}
+
+bool StationGraph::vertex_blocked(int departureKey, const RouteConstraints& constraints) const
+{
+    const Departure& departure = (*departureGraphList)[departureKey];
+    return departure.IsCancelled() || constraints.TripAvoided(departureKey) || constraints.StationAvoided(departure.GetStationID());
+}
+
+// DAG relaxation from whatever distances are already seeded, skipping blocked vertices. parent[w] is set to the
+// vertex w was reached from.
+template<class Metric>
+bool StationGraph::relax_in_time_order(int startTime, std::vector<int>& distance, std::vector<int>& parent, const RouteConstraints& constraints,
+    DeadlineMonitor* monitor)
+{
+    for(std::vector<int>::const_iterator it = sweep_start(startTime); it != searchIndexes->departureTimeOrder.end(); ++it)
+    {
+        prefetch_sweep(it, distance);
+        if(monitor && monitor->Expired())
+        {
+            return false;
+        }
+
+        int currentDistance = distance[*it];
+        if(currentDistance == Utility::INF)
+        {
+            continue;
+        }
+
+        const Departure& departure = (*departureGraphList)[*it];
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            const TripPlusLayover& trip = departure.GetTrip(i);
+            int newDistance = currentDistance + Metric::Weight(trip);
+            if(newDistance < distance[trip.destinationKey] && !vertex_blocked(trip.destinationKey, constraints))
+            {
+                distance[trip.destinationKey] = newDistance;
+                parent[trip.destinationKey] = *it;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<class Metric>
+Route StationGraph::get_constrained_route(int departureStationID, int destinationStationID, const RouteConstraints& constraints,
+    const std::vector<int>* originKeys, const QueryDeadline* deadline)
+{
+    // One layer per leg. Layer l holds paths that have already visited the first l via stations, a vertex at the
+    // next via station is copied into the layer above at the same weight, and the answer is read off the last layer.
+    const int vertexCount = departureGraphList->size();
+    const int layerCount = constraints.viaStationIDs.size() + 1;
+    const int sourceMarker = -1;
+    const int layerMarker = -2;
+
+    std::vector<std::vector<int>> distance(layerCount, std::vector<int>(vertexCount, Utility::INF));
+    std::vector<std::vector<int>> parent(layerCount, std::vector<int>(vertexCount, sourceMarker));
+    DeadlineMonitor monitor(deadline);
+
+    int startTime = Utility::INF;
+    for(int key : originKeys ? *originKeys : searchIndexes->stationDepartureIndex[departureStationID - 1])
+    {
+        if(!vertex_blocked(key, constraints))
+        {
+            distance[0][key] = 0;
+            startTime = std::min(startTime, (*departureGraphList)[key].GetDepartureTime());
+        }
+    }
+
+    for(int layer = 0; layer < layerCount; layer++)
+    {
+        // A leg can end at the via station's terminal with nothing left to relax, which is still a route
+        // when the via station is also the destination.
+        if(startTime != Utility::INF && !relax_in_time_order<Metric>(startTime, distance[layer], parent[layer], constraints, &monitor))
+        {
+            return {{{}, -1, -1, -1}, {}, RouteStatus::TimedOut};
+        }
+
+        if(layer + 1 < layerCount)
+        {
+            int viaStationID = constraints.viaStationIDs[layer];
+            if(viaStationID < 1 || viaStationID > stationCount)
+            {
+                return {{{}, -1, -1, -1}, {}};
+            }
+
+            startTime = Utility::INF;
+            std::vector<int> viaKeys = searchIndexes->stationDepartureIndex[viaStationID - 1];
+            viaKeys.push_back(searchIndexes->terminalKeyTable[viaStationID - 1]);
+            for(int key : viaKeys)
+            {
+                if(key >= 0 && distance[layer][key] != Utility::INF)
+                {
+                    distance[layer + 1][key] = distance[layer][key];
+                    parent[layer + 1][key] = layerMarker;
+                    if(!(*departureGraphList)[key].IsFinalDestination())
+                    {
+                        startTime = std::min(startTime, (*departureGraphList)[key].GetDepartureTime());
+                    }
+                }
+            }
+
+        }
+    }
+
+    int destinationKey = searchIndexes->terminalKeyTable[destinationStationID - 1];
+    if(destinationKey < 0 || distance[layerCount - 1][destinationKey] == Utility::INF)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    // Walk back through the layers to the boarding vertex.
+    std::vector<int> pathKeys;
+    int currentKey = destinationKey;
+    int layer = layerCount - 1;
+    pathKeys.push_back(currentKey);
+    while(true)
+    {
+        int previousKey = parent[layer][currentKey];
+        if(previousKey == layerMarker)
+        {
+            layer--;
+        }
+        else if(previousKey == sourceMarker)
+        {
+            break;
+        }
+        else
+        {
+            currentKey = previousKey;
+            pathKeys.push_back(currentKey);
+        }
+    }
+
+    std::reverse(pathKeys.begin(), pathKeys.end());
+    return build_route_from_path(pathKeys);
+}
+
+Route StationGraph::GetConstrainedRoute(int departureStationID, int destinationStationID, const RouteConstraints& constraints, bool includeLayovers,
+    const QueryDeadline* deadline)
+{
+    if(departureStationID < 1 || departureStationID > stationCount || destinationStationID < 1 || destinationStationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    if(includeLayovers)
+    {
+        return get_constrained_route<LayoverMetric>(departureStationID, destinationStationID, constraints, nullptr, deadline);
+    }
+    else
+    {
+        return get_constrained_route<RideTimeMetric>(departureStationID, destinationStationID, constraints, nullptr, deadline);
+    }
+}
+
+// Dijkstra seeded with every departure of every origin at weight 0. Terminal vertices have no edges, so the first
+// destination terminal taken off the heap is the lightest route into the group and the search stops there.
+template<class Metric>
+Route StationGraph::get_group_shortest_route(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs,
+    const QueryDeadline* deadline)
+{
+    typedef std::pair<int, int> WeightedKey;
+
+    std::vector<int> distance(departureGraphList->size(), Utility::INF);
+    std::vector<int> parent(departureGraphList->size(), -1);
+    std::vector<bool> settled(departureGraphList->size(), false);
+    std::vector<bool> destinationTerminal(departureGraphList->size(), false);
+    // Equal weights pop in record order, so the numbering doesn't decide between equally short routes.
+    const std::vector<int>& recordIndexTable = searchIndexes->recordIndexTable;
+    auto popsAfter = [&recordIndexTable](const WeightedKey& key1, const WeightedKey& key2) {
+        return key1.first > key2.first || (key1.first == key2.first && recordIndexTable[key1.second] > recordIndexTable[key2.second]);
+    };
+    std::priority_queue<WeightedKey, std::vector<WeightedKey>, decltype(popsAfter)> frontier(popsAfter);
+
+    for(int destinationStationID : destinationStationIDs)
+    {
+        if(destinationStationID >= 1 && destinationStationID <= stationCount && searchIndexes->terminalKeyTable[destinationStationID - 1] >= 0)
+        {
+            destinationTerminal[searchIndexes->terminalKeyTable[destinationStationID - 1]] = true;
+        }
+    }
+
+    for(int departureStationID : departureStationIDs)
+    {
+        if(departureStationID < 1 || departureStationID > stationCount)
+        {
+            continue;
+        }
+
+        for(int key : searchIndexes->stationDepartureIndex[departureStationID - 1])
+        {
+            if(distance[key] != 0 && !(*departureGraphList)[key].IsCancelled())
+            {
+                distance[key] = 0;
+                frontier.push({0, key});
+            }
+        }
+    }
+
+    DeadlineMonitor monitor(deadline);
+    while(!frontier.empty())
+    {
+        if(monitor.Expired())
+        {
+            return {{{}, -1, -1, -1}, {}, RouteStatus::TimedOut};
+        }
+
+        WeightedKey current = frontier.top();
+        frontier.pop();
+        if(settled[current.second])
+        {
+            continue;
+        }
+        settled[current.second] = true;
+
+        if(destinationTerminal[current.second])
+        {
+            std::vector<int> pathKeys;
+            for(int key = current.second; key >= 0; key = parent[key])
+            {
+                pathKeys.push_back(key);
+            }
+            std::reverse(pathKeys.begin(), pathKeys.end());
+            return build_route_from_path(pathKeys);
+        }
+
+        const Departure& departure = (*departureGraphList)[current.second];
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            const TripPlusLayover& trip = departure.GetTrip(i);
+            int newDistance = current.first + Metric::Weight(trip);
+            if(newDistance < distance[trip.destinationKey])
+            {
+                distance[trip.destinationKey] = newDistance;
+                parent[trip.destinationKey] = current.second;
+                frontier.push({newDistance, trip.destinationKey});
+            }
+        }
+    }
+
+    return {{{}, -1, -1, -1}, {}};
+}
+
+Route StationGraph::GetGroupShortestRoute(const std::vector<int>& departureStationIDs, const std::vector<int>& destinationStationIDs, bool includeLayovers,
+    const QueryDeadline* deadline)
+{
+    if(includeLayovers)
+    {
+        return get_group_shortest_route<LayoverMetric>(departureStationIDs, destinationStationIDs, deadline);
+    }
+    else
+    {
+        return get_group_shortest_route<RideTimeMetric>(departureStationIDs, destinationStationIDs, deadline);
+    }
+}
+
+template<class Metric>
+Route StationGraph::get_anytime_shortest_route(int departureStationID, int destinationStationID, const SequenceTable* routeLookUpTable,
+    const QueryDeadline& deadline)
+{
+    Route bestRoute{{{}, -1, -1, -1}, {}};
+    int bestWeight = Utility::INF;
+    int destinationKey = searchIndexes->terminalKeyTable[destinationStationID - 1];
+    if(destinationKey < 0)
+    {
+        return bestRoute;
+    }
+
+    // Without tables each train gets its own sweep, which skips anything already as heavy as the best journey.
+    std::vector<int> distance;
+    std::vector<int> parent;
+    if(!routeLookUpTable)
+    {
+        distance.resize(departureGraphList->size());
+        parent.resize(departureGraphList->size());
+    }
+
+    DeadlineMonitor monitor(&deadline);
+    bool expired = false;
+    for(int originKey : searchIndexes->stationDepartureIndex[departureStationID - 1])
+    {
+        if((expired = monitor.Expired()))
+        {
+            break;
+        }
+        if((*departureGraphList)[originKey].IsCancelled())
+        {
+            continue;
+        }
+
+        if(routeLookUpTable)
+        {
+            Route candidate = get_route(originKey, destinationKey, *routeLookUpTable);
+            if(candidate.RouteIsValid() && RouteWeight<Metric>(candidate) < bestWeight)
+            {
+                bestWeight = RouteWeight<Metric>(candidate);
+                bestRoute = candidate;
+            }
+            continue;
+        }
+
+        std::fill(distance.begin(), distance.end(), Utility::INF);
+        std::fill(parent.begin(), parent.end(), -1);
+        distance[originKey] = 0;
+        for(std::vector<int>::const_iterator it = sweep_start((*departureGraphList)[originKey].GetDepartureTime()); it != searchIndexes->departureTimeOrder.end(); ++it)
+        {
+            prefetch_sweep(it, distance);
+            if((expired = monitor.Expired()))
+            {
+                break;
+            }
+
+            int currentDistance = distance[*it];
+            if(currentDistance >= bestWeight)
+            {
+                continue;
+            }
+
+            const Departure& departure = (*departureGraphList)[*it];
+            for(int i = 0; i < departure.GetTripCount(); i++)
+            {
+                const TripPlusLayover& trip = departure.GetTrip(i);
+                int newDistance = currentDistance + Metric::Weight(trip);
+                if(newDistance < distance[trip.destinationKey] && !(*departureGraphList)[trip.destinationKey].IsCancelled())
+                {
+                    distance[trip.destinationKey] = newDistance;
+                    parent[trip.destinationKey] = *it;
+                }
+            }
+        }
+        if(expired)
+        {
+            break;
+        }
+
+        if(distance[destinationKey] < bestWeight)
+        {
+            std::vector<int> pathKeys;
+            for(int key = destinationKey; key >= 0; key = parent[key])
+            {
+                pathKeys.push_back(key);
+            }
+            std::reverse(pathKeys.begin(), pathKeys.end());
+            bestWeight = distance[destinationKey];
+            bestRoute = build_route_from_path(pathKeys);
+        }
+    }
+
+    if(expired)
+    {
+        bestRoute.status = bestRoute.RouteIsValid() ? RouteStatus::Unproven : RouteStatus::TimedOut;
+    }
+    return bestRoute;
+}
+
+Route StationGraph::GetAnytimeShortestRoute(int departureStationID, int destinationStationID, bool includeLayovers, const QueryDeadline& deadline)
+{
+    if(departureStationID < 1 || departureStationID > stationCount || destinationStationID < 1 || destinationStationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    bool useTables = TablesReady();
+    if(includeLayovers)
+    {
+        return get_anytime_shortest_route<LayoverMetric>(departureStationID, destinationStationID,
+            useTables ? shortestRouteWithLayoverSequenceTable : nullptr, deadline);
+    }
+    else
+    {
+        return get_anytime_shortest_route<RideTimeMetric>(departureStationID, destinationStationID,
+            useTables ? shortestRouteWithoutLayoverSequenceTable : nullptr, deadline);
+    }
+}
+
+void StationGraph::closure_weights_from_station(int departureStationID, const RouteConstraints& constraints, std::vector<int>& stationWeights,
+    std::vector<int>* usedKeys)
+{
+    std::vector<int> distance(departureGraphList->size(), Utility::INF);
+    std::vector<int> parent(departureGraphList->size(), -1);
+
+    int startTime = Utility::INF;
+    for(int key : searchIndexes->stationDepartureIndex[departureStationID - 1])
+    {
+        if(!vertex_blocked(key, constraints))
+        {
+            distance[key] = 0;
+            startTime = std::min(startTime, (*departureGraphList)[key].GetDepartureTime());
+        }
+    }
+    if(startTime != Utility::INF)
+    {
+        relax_in_time_order<LayoverMetric>(startTime, distance, parent, constraints);
+    }
+
+    // Paths to different stations share their beginnings, each vertex is collected once.
+    std::vector<char> collected(usedKeys ? departureGraphList->size() : 0, 0);
+    stationWeights.assign(stationCount, Utility::INF);
+    for(int stationIndex = 0; stationIndex < stationCount; stationIndex++)
+    {
+        int terminalKey = searchIndexes->terminalKeyTable[stationIndex];
+        if(terminalKey < 0 || distance[terminalKey] == Utility::INF)
+        {
+            continue;
+        }
+
+        stationWeights[stationIndex] = distance[terminalKey];
+        for(int key = terminalKey; usedKeys && key >= 0 && !collected[key]; key = parent[key])
+        {
+            collected[key] = 1;
+            usedKeys->push_back(key);
+        }
+    }
+}
+
+std::vector<ClosureImpact> StationGraph::GetClosureImpacts(bool closeTrips, int threadCount, PoolMetrics* metrics)
+{
+    WorkStealingPool pool(threadCount);
+
+    // Baseline weights for every origin, and for every vertex the origins whose shortest paths use it. Closing a
+    // station or train can only take paths away, so an origin that never used it keeps all of its weights.
+    std::vector<std::vector<int>> baseWeights(stationCount);
+    std::vector<std::vector<int>> usedKeys(stationCount);
+    const RouteConstraints noConstraints;
+    pool.ParallelFor(0, stationCount, [&](int stationIndex, int) {
+        closure_weights_from_station(stationIndex + 1, noConstraints, baseWeights[stationIndex], &usedKeys[stationIndex]);
+    });
+
+    std::vector<std::vector<int>> keyOrigins(departureGraphList->size());
+    for(int stationIndex = 0; stationIndex < stationCount; stationIndex++)
+    {
+        for(int key : usedKeys[stationIndex])
+        {
+            keyOrigins[key].push_back(stationIndex + 1);
+        }
+        std::vector<int>().swap(usedKeys[stationIndex]);
+    }
+
+    std::vector<ClosureImpact> impacts;
+    if(closeTrips)
+    {
+        for(int key : searchIndexes->departureTimeOrder)
+        {
+            if(!(*departureGraphList)[key].IsCancelled())
+            {
+                impacts.push_back({-1, key, 0, 0, 0});
+            }
+        }
+    }
+    else
+    {
+        for(int stationID = 1; stationID <= stationCount; stationID++)
+        {
+            impacts.push_back({stationID, -1, 0, 0, 0});
+        }
+    }
+
+    pool.ParallelFor(0, impacts.size(), [&](int closureIndex, int) {
+        ClosureImpact& impact = impacts[closureIndex];
+        RouteConstraints constraints;
+        std::vector<int> affectedOrigins;
+        if(impact.stationID > 0)
+        {
+            constraints.AvoidStation(impact.stationID);
+            std::vector<int> closedKeys = searchIndexes->stationDepartureIndex[impact.stationID - 1];
+            closedKeys.push_back(searchIndexes->terminalKeyTable[impact.stationID - 1]);
+            for(int key : closedKeys)
+            {
+                if(key >= 0)
+                {
+                    affectedOrigins.insert(affectedOrigins.end(), keyOrigins[key].begin(), keyOrigins[key].end());
+                }
+            }
+            std::sort(affectedOrigins.begin(), affectedOrigins.end());
+            affectedOrigins.erase(std::unique(affectedOrigins.begin(), affectedOrigins.end()), affectedOrigins.end());
+        }
+        else
+        {
+            constraints.AvoidTrip(impact.departureKey);
+            affectedOrigins = keyOrigins[impact.departureKey];
+        }
+
+        std::vector<int> weights;
+        for(int originID : affectedOrigins)
+        {
+            if(originID == impact.stationID)
+            {
+                continue;
+            }
+
+            impact.recomputedOrigins++;
+            closure_weights_from_station(originID, constraints, weights, nullptr);
+            for(int stationIndex = 0; stationIndex < stationCount; stationIndex++)
+            {
+                int baseWeight = baseWeights[originID - 1][stationIndex];
+                if(stationIndex + 1 == originID || stationIndex + 1 == impact.stationID || baseWeight == Utility::INF)
+                {
+                    continue;
+                }
+
+                if(weights[stationIndex] == Utility::INF)
+                {
+                    impact.disconnectedPairs++;
+                }
+                else
+                {
+                    impact.addedMinutes += weights[stationIndex] - baseWeight;
+                }
+            }
+        }
+    });
+
+    if(metrics)
+    {
+        *metrics = pool.GetMetrics();
+    }
+
+    std::stable_sort(impacts.begin(), impacts.end(), [](const ClosureImpact& impact1, const ClosureImpact& impact2) {
+        return impact1.disconnectedPairs > impact2.disconnectedPairs
+            || (impact1.disconnectedPairs == impact2.disconnectedPairs && impact1.addedMinutes > impact2.addedMinutes);
+    });
+    return impacts;
+}
+
+int StationGraph::accumulate_betweenness(int originKey, std::vector<double>& stationScores, std::vector<double>& departureScores)
+{
+    // distance and pathCount are the layover weight and number of shortest paths from the origin departure to each
+    // vertex. Edges lead to later departures, so both are final once the time order sweep reaches a vertex.
+    const Departure& origin = (*departureGraphList)[originKey];
+    if(origin.IsCancelled() || origin.GetTripCount() == 0)
+    {
+        return 0;
+    }
+
+    std::vector<int> distance(departureGraphList->size(), Utility::INF);
+    std::vector<double> pathCount(departureGraphList->size(), 0);
+    std::vector<double> dependency(departureGraphList->size(), 0);
+    std::vector<char> isTarget(departureGraphList->size(), 0);
+    int departureStationID = origin.GetStationID();
+    distance[originKey] = 0;
+    pathCount[originKey] = 1;
+
+    std::vector<int>::const_iterator sweepBegin = sweep_start(origin.GetDepartureTime());
+    for(std::vector<int>::const_iterator it = sweepBegin; it != searchIndexes->departureTimeOrder.end(); ++it)
+    {
+        prefetch_sweep(it, distance);
+        int currentDistance = distance[*it];
+        if(currentDistance == Utility::INF)
+        {
+            continue;
+        }
+
+        const Departure& departure = (*departureGraphList)[*it];
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            const TripPlusLayover& trip = departure.GetTrip(i);
+            if((*departureGraphList)[trip.destinationKey].IsCancelled())
+            {
+                continue;
+            }
+
+            int newDistance = currentDistance + LayoverMetric::Weight(trip);
+            if(newDistance < distance[trip.destinationKey])
+            {
+                distance[trip.destinationKey] = newDistance;
+                pathCount[trip.destinationKey] = pathCount[*it];
+            }
+            else if(newDistance == distance[trip.destinationKey])
+            {
+                pathCount[trip.destinationKey] += pathCount[*it];
+            }
+        }
+    }
+
+    // Each reached station other than the origin is the end of one journey, arriving at its terminal vertex.
+    int reachedCount = 0;
+    for(int stationIndex = 0; stationIndex < stationCount; stationIndex++)
+    {
+        int terminalKey = searchIndexes->terminalKeyTable[stationIndex];
+        if(stationIndex + 1 != departureStationID && terminalKey >= 0 && distance[terminalKey] != Utility::INF)
+        {
+            isTarget[terminalKey] = 1;
+            reachedCount++;
+        }
+    }
+
+    // Backwards in time, a vertex's dependency is the share of journeys through each shortest path successor that
+    // came through it, plus the journeys ending at that successor.
+    for(std::vector<int>::const_iterator it = searchIndexes->departureTimeOrder.end(); it != sweepBegin;)
+    {
+        --it;
+        if(distance[*it] == Utility::INF)
+        {
+            continue;
+        }
+
+        const Departure& departure = (*departureGraphList)[*it];
+        for(int i = 0; i < departure.GetTripCount(); i++)
+        {
+            const TripPlusLayover& trip = departure.GetTrip(i);
+            if(distance[*it] + LayoverMetric::Weight(trip) == distance[trip.destinationKey] && !(*departureGraphList)[trip.destinationKey].IsCancelled())
+            {
+                dependency[*it] += pathCount[*it] / pathCount[trip.destinationKey] * (isTarget[trip.destinationKey] + dependency[trip.destinationKey]);
+            }
+        }
+
+        departureScores[*it] += dependency[*it];
+        if(departure.GetStationID() != departureStationID)
+        {
+            stationScores[departure.GetStationID() - 1] += dependency[*it];
+        }
+    }
+
+    return reachedCount;
+}
+
+BetweennessScores StationGraph::GetBetweenness(int threadCount, PoolMetrics* metrics)
+{
+    WorkStealingPool pool(threadCount);
+
+    // Origin departures are dealt to a fixed number of partial sums, merged in order afterwards, so the scores don't
+    // depend on which worker ran which origin.
+    int departureCount = departureGraphList->size();
+    int partCount = std::min(departureCount, 4 * pool.GetThreadCount());
+    std::vector<std::vector<double>> stationParts(partCount, std::vector<double>(stationCount, 0));
+    std::vector<std::vector<double>> departureParts(partCount, std::vector<double>(departureGraphList->size(), 0));
+    std::vector<long long> journeyParts(partCount, 0);
+    for(int part = 0; part < partCount; part++)
+    {
+        pool.Submit([this, part, partCount, departureCount, &stationParts, &departureParts, &journeyParts] {
+            for(int originKey = part; originKey < departureCount; originKey += partCount)
+            {
+                journeyParts[part] += accumulate_betweenness(originKey, stationParts[part], departureParts[part]);
+            }
+        });
+    }
+    pool.Wait();
+    if(metrics)
+    {
+        *metrics = pool.GetMetrics();
+    }
+
+    BetweennessScores scores{std::vector<double>(stationCount, 0), std::vector<double>(departureGraphList->size(), 0), 0};
+    for(int part = 0; part < partCount; part++)
+    {
+        for(int i = 0; i < stationCount; i++)
+        {
+            scores.stationScores[i] += stationParts[part][i];
+        }
+        for(int i = 0; i < departureGraphList->size(); i++)
+        {
+            scores.departureScores[i] += departureParts[part][i];
+        }
+        scores.journeyCount += journeyParts[part];
+    }
+
+    return scores;
+}
+
+int StationGraph::GetEarliestArrivalFromDeparture(int departureKey, int destinationStationID, const QueryDeadline* deadline, RouteStatus* status)
+{
+    if(status) *status = RouteStatus::Complete;
+    if(departureKey < 0 || departureKey >= departureGraphList->size() || destinationStationID < 1 || destinationStationID > stationCount
+        || searchIndexes->terminalKeyTable[destinationStationID - 1] < 0)
+    {
+        return Utility::INF;
+    }
+
+    // Terminals are not trains anyone rides, the labels would otherwise report one as arriving at its own station.
+    const Departure& departure = (*departureGraphList)[departureKey];
+    if(departure.IsCancelled() || departure.IsFinalDestination())
+    {
+        return Utility::INF;
+    }
+
+    // Layover weights telescope, the weight to the terminal is the arrival time less the departure time.
+    int destinationKey = searchIndexes->terminalKeyTable[destinationStationID - 1];
+    // A label lookup is one short merge, only the search needs the deadline. Labels built in the background are only
+    // read once TablesReady publishes them.
+    int weight = TablesReady() && hubLabelIndex ? hubLabelIndex->Distance(departureKey, destinationKey)
+        : search_earliest_arrival_from_departure(departureKey, destinationKey, deadline, status);
+    return weight == Utility::INF ? Utility::INF : departure.GetDepartureTime() + weight;
+}
+
+bool StationGraph::DepartureReachesStation(int departureKey, int destinationStationID)
+{
+    return GetEarliestArrivalFromDeparture(departureKey, destinationStationID) != Utility::INF;
+}
+
+size_t StationGraph::GetHubLabelEntryCount()
+{
+    return TablesReady() && hubLabelIndex ? hubLabelIndex->GetLabelEntryCount() : 0;
+}
+
+int StationGraph::GetRoutePatternCount()
+{
+    return routePatternTable ? routePatternTable->GetPatternCount() : 0;
+}
+
+int StationGraph::GetFrequencyServiceCount()
+{
+    return routePatternTable ? routePatternTable->GetFrequencyServiceCount() : 0;
+}
+
+// Minimum layover weight from one departure to another, found by relaxing from it.
+int StationGraph::search_earliest_arrival_from_departure(int departureKey, int destinationKey, const QueryDeadline* deadline, RouteStatus* status)
+{
+    const Departure& departure = (*departureGraphList)[departureKey];
+    std::vector<int> distance(departureGraphList->size(), Utility::INF);
+    std::vector<int> parent(departureGraphList->size(), -1);
+    distance[departureKey] = 0;
+    DeadlineMonitor monitor(deadline);
+    if(!relax_in_time_order<LayoverMetric>(departure.GetDepartureTime(), distance, parent, RouteConstraints(), &monitor))
+    {
+        if(status) *status = RouteStatus::TimedOut;
+        return Utility::INF;
+    }
+    return distance[destinationKey];
+}
+
+// Same rules as get_shortest_route_from_time, board only a train leaving at twentyFourTime.
+Route StationGraph::search_route_from_time(int departureID, int destinationID, int twentyFourTime, const QueryDeadline* deadline)
+{
+    if(departureID < 1 || departureID > stationCount || destinationID < 1 || destinationID > stationCount)
+    {
+        return {{{}, -1, -1, -1}, {}};
+    }
+
+    std::vector<int> originKeys;
+    for(int key : searchIndexes->stationDepartureIndex[departureID - 1])
+    {
+        int departureTime = (*departureGraphList)[key].GetDepartureTime();
+        if(departureTime == twentyFourTime || departureTime == twentyFourTime - 1200)
+        {
+            originKeys.push_back(key);
+        }
+    }
+
+    return get_constrained_route<LayoverMetric>(departureID, destinationID, RouteConstraints(), &originKeys, deadline);
+}
+
+bool StationGraph::direct_departure_exists(int departureID, int destinationID)
+{
+    if(departureID < 1 || departureID > stationCount || destinationID < 1 || destinationID > stationCount)
+    {
+        return false;
+    }
+
+    for(int key : searchIndexes->stationDepartureIndex[departureID - 1])
+    {
+        const Departure& departure = (*departureGraphList)[key];
+        if(!departure.IsCancelled() && destination_station(departure) == destinationID)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+StationGraph* StationGraph::Fork()
+{
+    return new StationGraph(this);
+}
+
+bool StationGraph::CancelDeparture(int departureKey)
+{
+    if(!baseGraph || departureKey < 0 || departureKey >= departureGraphList->size())
+    {
+        return false;
+    }
+
+    const Departure& departure = (*departureGraphList)[departureKey];
+    if(departure.IsFinalDestination() || departure.IsCancelled())
+    {
+        return false;
+    }
+
+    // Boarding is refused by the engines, connecting into it is removed from the trains that fed it.
+    departureGraphList->Mutable(departureKey).Cancel();
+    for(int predecessorKey : searchIndexes->predecessorTable[departureKey])
+    {
+        departureGraphList->Mutable(predecessorKey).RemoveTripTo(departureKey);
+    }
+
+    return true;
+}
+
+bool StationGraph::IsScenario()
+{
+    return baseGraph != nullptr;
+}
+
+int StationGraph::GetDepartureBlockCount()
+{
+    return departureGraphList->GetBlockCount();
+}
+
+int StationGraph::GetCopiedDepartureBlockCount()
+{
+    return departureGraphList->GetCopiedBlockCount();
+}
@@ -0,0 +1,264 @@
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include "utility.hpp"
+#include "timetable_codec.hpp"
+
+namespace
+{
+    const char timetableMagic[4] = {'T', 'T', 'B', '1'};
+    const int32_t timetableVersion = 1;
+}
+
+void TimetableWriter::put_varint(std::string& out, uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        out.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+std::string TimetableWriter::Encode(const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<FrequencyService>& services)
+{
+    std::vector<TimetableTrip> trips;
+    for(const std::vector<std::string>& record : tripDataTable)
+    {
+        if(record.size() >= 4)
+        {
+            trips.push_back({stoi(record[0]), {stoi(record[1]), stoi(record[2]), stoi(record[3])}});
+        }
+    }
+    std::sort(trips.begin(), trips.end(), [](const TimetableTrip& a, const TimetableTrip& b) {
+        if(a.departureStationID != b.departureStationID) return a.departureStationID < b.departureStationID;
+        if(a.trip.departureTime != b.trip.departureTime) return a.trip.departureTime < b.trip.departureTime;
+        if(a.trip.destinationID != b.trip.destinationID) return a.trip.destinationID < b.trip.destinationID;
+        return a.trip.arrivalTime < b.trip.arrivalTime;
+    });
+
+    TimetableHeader header = {};
+    memcpy(header.magic, timetableMagic, sizeof(timetableMagic));
+    header.version = timetableVersion;
+    header.tripCount = trips.size();
+    header.blockCount = (trips.size() + TimetableBlockTrips - 1) / TimetableBlockTrips;
+    header.serviceCount = services.size();
+
+    std::vector<TimetableBlockIndex> blockIndex(header.blockCount);
+    std::string blockBytes;
+    size_t blocksStart = sizeof(TimetableHeader) + blockIndex.size() * sizeof(TimetableBlockIndex);
+    for(int block = 0; block < header.blockCount; block++)
+    {
+        int first = block * TimetableBlockTrips;
+        int last = std::min((int)trips.size(), first + TimetableBlockTrips);
+        blockIndex[block] = {(uint32_t)(blocksStart + blockBytes.size()), trips[first].departureStationID};
+
+        // Deltas restart at every block so each one decodes on its own.
+        int previousStationID = 0;
+        int previousDepartureMins = 0;
+        for(int i = first; i < last; i++)
+        {
+            const TimetableTrip& current = trips[i];
+            int departureMins = Utility::TwentyFourTimeToMinutes(current.trip.departureTime);
+            int rideMins = Utility::TwentyFourTimeToMinutes(current.trip.arrivalTime) - departureMins;
+            bool sameStation = current.departureStationID == previousStationID;
+
+            put_varint(blockBytes, current.departureStationID - previousStationID);
+            put_varint(blockBytes, current.trip.destinationID);
+            put_varint(blockBytes, sameStation ? departureMins - previousDepartureMins : departureMins);
+            // Rides never cross midnight, but zigzag keeps a bad record from corrupting the stream.
+            put_varint(blockBytes, rideMins >= 0 ? (uint32_t)rideMins << 1 : ((uint32_t)(-rideMins) << 1) - 1);
+
+            previousStationID = current.departureStationID;
+            previousDepartureMins = departureMins;
+        }
+    }
+
+    header.serviceOffset = blocksStart + blockBytes.size();
+    std::string serviceBytes;
+    for(const FrequencyService& service : services)
+    {
+        put_varint(serviceBytes, service.departureStationID);
+        put_varint(serviceBytes, service.destinationStationID);
+        put_varint(serviceBytes, Utility::TwentyFourTimeToMinutes(service.firstDepartureTime));
+        put_varint(serviceBytes, Utility::TwentyFourTimeToMinutes(service.lastDepartureTime));
+        put_varint(serviceBytes, service.headwayMins);
+        put_varint(serviceBytes, service.rideMins);
+    }
+    header.totalBytes = header.serviceOffset + serviceBytes.size();
+
+    std::string out((const char*)&header, sizeof(header));
+    out.append((const char*)blockIndex.data(), blockIndex.size() * sizeof(TimetableBlockIndex));
+    out += blockBytes;
+    out += serviceBytes;
+    return out;
+}
+
+bool TimetableWriter::Write(const std::string& path, const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<FrequencyService>& services)
+{
+    std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+    if(!outFile.is_open())
+    {
+        return false;
+    }
+
+    std::string encoded = Encode(tripDataTable, services);
+    outFile.write(encoded.data(), encoded.size());
+    return outFile.good();
+}
+
+TimetableReader::TimetableReader(const char* data, size_t size) : bytes((const unsigned char*)data), byteCount(size), header(), valid(false)
+{
+    if(!IsTimetable(data, size) || size < sizeof(TimetableHeader))
+    {
+        return;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    size_t indexEnd = sizeof(TimetableHeader) + (size_t)header.blockCount * sizeof(TimetableBlockIndex);
+    valid = header.version == timetableVersion && header.tripCount >= 0 && header.blockCount >= 0 && header.serviceCount >= 0
+        && header.totalBytes <= size && indexEnd <= header.serviceOffset && header.serviceOffset <= header.totalBytes
+        && header.blockCount == (header.tripCount + TimetableBlockTrips - 1) / TimetableBlockTrips;
+}
+
+bool TimetableReader::IsTimetable(const char* data, size_t size)
+{
+    return size >= sizeof(timetableMagic) && memcmp(data, timetableMagic, sizeof(timetableMagic)) == 0;
+}
+
+bool TimetableReader::IsValid() const
+{
+    return valid;
+}
+
+int TimetableReader::GetTripCount() const
+{
+    return header.tripCount;
+}
+
+int TimetableReader::GetBlockCount() const
+{
+    return header.blockCount;
+}
+
+int TimetableReader::GetBlockFirstStation(int block) const
+{
+    TimetableBlockIndex entry;
+    memcpy(&entry, bytes + sizeof(TimetableHeader) + block * sizeof(TimetableBlockIndex), sizeof(entry));
+    return entry.firstStationID;
+}
+
+bool TimetableReader::get_varint(size_t& position, size_t end, uint32_t& value) const
+{
+    value = 0;
+    for(int shift = 0; shift < 35; shift += 7)
+    {
+        if(position >= end)
+        {
+            return false;
+        }
+
+        unsigned char byte = bytes[position++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if(!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TimetableReader::ReadBlock(int block, std::vector<TimetableTrip>& trips) const
+{
+    if(!valid || block < 0 || block >= header.blockCount)
+    {
+        return false;
+    }
+
+    TimetableBlockIndex entry;
+    memcpy(&entry, bytes + sizeof(TimetableHeader) + block * sizeof(TimetableBlockIndex), sizeof(entry));
+    size_t position = entry.byteOffset;
+    size_t end = header.serviceOffset;
+    int tripCount = std::min(TimetableBlockTrips, header.tripCount - block * TimetableBlockTrips);
+
+    int stationID = 0;
+    int departureMins = 0;
+    for(int i = 0; i < tripCount; i++)
+    {
+        uint32_t stationDelta, destinationID, departureField, rideField;
+        if(!get_varint(position, end, stationDelta) || !get_varint(position, end, destinationID)
+            || !get_varint(position, end, departureField) || !get_varint(position, end, rideField))
+        {
+            return false;
+        }
+
+        stationID += stationDelta;
+        departureMins = stationDelta == 0 ? departureMins + departureField : departureField;
+        int rideMins = (rideField & 1) ? -(int)((rideField + 1) >> 1) : (int)(rideField >> 1);
+        trips.push_back({stationID, {(int)destinationID, Utility::MinutesToTwentyFourTime(departureMins),
+            Utility::MinutesToTwentyFourTime(departureMins + rideMins)}});
+    }
+
+    return true;
+}
+
+bool TimetableReader::ReadFrequencyServices(std::vector<FrequencyService>& services) const
+{
+    if(!valid)
+    {
+        return false;
+    }
+
+    size_t position = header.serviceOffset;
+    for(int i = 0; i < header.serviceCount; i++)
+    {
+        uint32_t fields[6];
+        for(uint32_t& field : fields)
+        {
+            if(!get_varint(position, header.totalBytes, field))
+            {
+                return false;
+            }
+        }
+        services.push_back({(int)fields[0], (int)fields[1], Utility::MinutesToTwentyFourTime(fields[2]),
+            Utility::MinutesToTwentyFourTime(fields[3]), (int)fields[4], (int)fields[5]});
+    }
+
+    return true;
+}
+
+std::string TimetableReader::format_twenty_four_time(int twentyFourTime)
+{
+    // Other readers compare times as strings, keep them four digits.
+    char digits[5] = {(char)('0' + twentyFourTime / 1000 % 10), (char)('0' + twentyFourTime / 100 % 10),
+        (char)('0' + twentyFourTime / 10 % 10), (char)('0' + twentyFourTime % 10), '\0'};
+    return std::string(digits, 4);
+}
+
+bool TimetableReader::ReadTripDataTable(std::vector<std::vector<std::string>>& tripDataTable) const
+{
+    if(!valid)
+    {
+        return false;
+    }
+
+    std::vector<TimetableTrip> trips;
+    trips.reserve(TimetableBlockTrips);
+    tripDataTable.reserve(tripDataTable.size() + header.tripCount);
+    for(int block = 0; block < header.blockCount; block++)
+    {
+        trips.clear();
+        if(!ReadBlock(block, trips))
+        {
+            return false;
+        }
+
+        for(const TimetableTrip& current : trips)
+        {
+            tripDataTable.push_back({std::to_string(current.departureStationID), std::to_string(current.trip.destinationID),
+                format_twenty_four_time(current.trip.departureTime), format_twenty_four_time(current.trip.arrivalTime)});
+        }
+    }
+
+    return true;
+}
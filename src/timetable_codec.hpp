@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "trip.hpp"
+#include "frequency_service.hpp"
+
+/*
+    Compact binary form of trains.dat for shipping timetables. Trips are sorted by departure station and time and
+    cut into blocks of TimetableBlockTrips. Inside a block each trip is a run of varints: the departure station as a
+    delta from the previous trip, the destination id, the departure time in minutes (a delta from the previous trip
+    unless the station changed) and the ride time in minutes. A fixed size index gives each block's byte offset and
+    first station, so a reader can seek straight to a station or decode blocks as they stream in. Frequency records
+    follow the blocks, one varint run each.
+
+    Layout: TimetableHeader, blockCount TimetableBlockIndex entries, trip blocks, frequency services.
+    Readers work on the bytes in place, a mapped file or a string read from disk both work.
+*/
+
+const int TimetableBlockTrips = 128;
+
+struct TimetableHeader {
+    char magic[4];
+    int32_t version;
+    int32_t tripCount;
+    int32_t blockCount;
+    int32_t serviceCount;
+    uint32_t serviceOffset;
+    uint32_t totalBytes;
+};
+
+struct TimetableBlockIndex {
+    uint32_t byteOffset;
+    int32_t firstStationID;
+};
+
+// One decoded trip, Trip plus the station it leaves from. Times are HHMM.
+struct TimetableTrip {
+    int departureStationID;
+    Trip trip;
+};
+
+class TimetableWriter{
+    public:
+        // Encode trip records (as read from trains.dat) and frequency services.
+        static std::string Encode(const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<FrequencyService>& services);
+        static bool Write(const std::string& path, const std::vector<std::vector<std::string>>& tripDataTable, const std::vector<FrequencyService>& services);
+    private:
+        static void put_varint(std::string& out, uint32_t value);
+};
+
+class TimetableReader{
+    public:
+        // Bytes must stay alive and unchanged for the life of the reader.
+        TimetableReader(const char* data, size_t size);
+        // True if data starts with the timetable magic, text trains.dat never does.
+        static bool IsTimetable(const char* data, size_t size);
+        // False if the header, index or sizes don't check out.
+        bool IsValid() const;
+        int GetTripCount() const;
+        int GetBlockCount() const;
+        int GetBlockFirstStation(int block) const;
+        // Appends the trips of one block. Returns false if the block is corrupt.
+        bool ReadBlock(int block, std::vector<TimetableTrip>& trips) const;
+        bool ReadFrequencyServices(std::vector<FrequencyService>& services) const;
+        // Decodes everything into trip records in the same form as the text parser produces.
+        bool ReadTripDataTable(std::vector<std::vector<std::string>>& tripDataTable) const;
+    private:
+        const unsigned char* bytes;
+        size_t byteCount;
+        TimetableHeader header;
+        bool valid;
+
+        // Reads a varint at position, advancing it. Returns false on overrun.
+        bool get_varint(size_t& position, size_t end, uint32_t& value) const;
+        static std::string format_twenty_four_time(int twentyFourTime);
+};
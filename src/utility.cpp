@@ -0,0 +1,79 @@
+#include <cctype>
+#include "utility.hpp"
+
+const int Utility::INF;
+
+void Utility::ClearInStream()
+{
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(),'\n');
+}
+
+void Utility::PrintMainMenu()
+{
+    std::cout << "========================================================================\n"
+    << "READING RAILWAYS SCHEDULER\n"
+    << "========================================================================\n"
+    << "Options - (Enter number of your selected option)\n"
+    << "(1) - Print full schedule\n"
+    << "(2) - Print station schedule\n"
+    << "(3) - Look up stationd id\n"
+    << "(4) - Look up station name\n"
+    << "(5) - Servie available\n"
+    << "(6) - Nonstop service available\n"
+    << "(7) - Find route (Shortest riding time)\n"
+    << "(8) - Find route (Shortest overall travel time)\n"
+    << "(9) - Find route (Shortest time, at specific departure time)\n"
+    << "(10) - Stations reachable within a time budget\n"
+    << "(11) - Find route (Latest departure, arriving by specific time)\n"
+    << "(12) - Find route (Through or avoiding a station)\n"
+    << "(13) - Find route (Between groups of stations)\n"
+    << "(0) - Exit\n";
+}
+
+int Utility::TwentyFourTimeToMinutes(int twentyFourTime)
+{
+    return (twentyFourTime / 100) * 60 + twentyFourTime % 100;
+}
+
+int Utility::MinutesToTwentyFourTime(int minutes)
+{
+    return (minutes / 60) * 100 + minutes % 60;
+}
+
+int Utility::GetIntFromUser()
+{
+    int val;
+    std::cin >> val;
+    while(std::cin.fail())
+    {
+        std::cout << "Invalid input, try again: ";
+        Utility::ClearInStream();
+        std::cin >> val;
+    }
+
+    return val;
+}
+
+bool Utility::CompareStringsNoCase(const std::string& s1, const std::string& s2)
+{
+    if(s1.size() != s2.size())
+    {
+        return false;
+    }
+
+    for(int i = 0; i < s1.size(); i++)
+    {
+        // Treat space and _ as same character in string comparisons.
+        if((s1[i] == '_' && s2[i] == ' ') || (s2[i] == '_' && s1[i] == ' '))
+        {
+            continue;
+        }
+
+        if(tolower(s1[i]) != tolower(s2[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include "work_stealing_pool.hpp"
+
+namespace
+{
+    // Index of the worker running on this thread and the pool it belongs to, so tasks can submit to their own queue.
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local int currentWorker = -1;
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount) : createdTime(Clock::now()), tasksSplit(0), queuedTasks(0), idleWorkers(0),
+    unfinishedTasks(0), nextQueue(0), stopping(false)
+{
+    if(threadCount <= 0)
+    {
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    for(int i = 0; i < threadCount; i++)
+    {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+    }
+    for(int i = 0; i < threadCount; i++)
+    {
+        workers.push_back(std::thread(&WorkStealingPool::worker_loop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::GetThreadCount() const
+{
+    return workers.size();
+}
+
+PoolMetrics WorkStealingPool::GetMetrics() const
+{
+    PoolMetrics metrics{(int)workers.size(), 0, 0, tasksSplit, 0, 0};
+    long long busyNanos = 0;
+    for(const std::unique_ptr<WorkerQueue>& queue : queues)
+    {
+        metrics.tasksRun += queue->tasksRun;
+        metrics.tasksStolen += queue->tasksStolen;
+        busyNanos += queue->busyNanos;
+    }
+    metrics.busySeconds = busyNanos / 1e9;
+    metrics.elapsedSeconds = std::chrono::duration<double>(Clock::now() - createdTime).count();
+    return metrics;
+}
+
+void WorkStealingPool::Submit(std::function<void()> task)
+{
+    int queueIndex;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queueIndex = (currentPool == this) ? currentWorker : nextQueue++ % queues.size();
+        unfinishedTasks++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->queueMutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queuedTasks++;
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return unfinishedTasks == 0; });
+}
+
+void WorkStealingPool::ParallelFor(int begin, int end, const std::function<void(int, int)>& body)
+{
+    if(begin < end)
+    {
+        Submit([this, begin, end, &body] { run_range(begin, end, body); });
+    }
+    Wait();
+}
+
+void WorkStealingPool::run_range(int begin, int end, const std::function<void(int, int)>& body)
+{
+    while(begin < end)
+    {
+        // Give the back half away only when a worker is asleep with nothing queued for it, it splits further
+        // the same way if more workers are idle.
+        if(end - begin > 1 && idleWorkers > 0 && queuedTasks == 0)
+        {
+            int middle = begin + (end - begin) / 2;
+            tasksSplit++;
+            Submit([this, middle, end, &body] { run_range(middle, end, body); });
+            end = middle;
+            continue;
+        }
+
+        body(begin++, currentWorker);
+    }
+}
+
+bool WorkStealingPool::try_pop(int workerIndex, std::function<void()>& task, bool& stolen)
+{
+    {
+        WorkerQueue& own = *queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.queueMutex);
+        if(!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            stolen = false;
+            return true;
+        }
+    }
+
+    for(int offset = 1; offset < queues.size(); offset++)
+    {
+        WorkerQueue& victim = *queues[(workerIndex + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.queueMutex);
+        if(!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::worker_loop(int workerIndex)
+{
+    currentPool = this;
+    currentWorker = workerIndex;
+    WorkerQueue& own = *queues[workerIndex];
+
+    while(true)
+    {
+        std::function<void()> task;
+        bool stolen;
+        if(try_pop(workerIndex, task, stolen))
+        {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                queuedTasks--;
+            }
+
+            Clock::time_point startTime = Clock::now();
+            task();
+            own.busyNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count();
+            own.tasksRun++;
+            own.tasksStolen += stolen;
+
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if(--unfinishedTasks == 0)
+            {
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // A task counted in queuedTasks may still be on its way into a queue, then the loop just tries again.
+        std::unique_lock<std::mutex> lock(stateMutex);
+        idleWorkers++;
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        idleWorkers--;
+        if(stopping && queuedTasks == 0)
+        {
+            return;
+        }
+    }
+}
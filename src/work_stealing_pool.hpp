@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+/*
+    Work stealing thread pool for batches of independent searches. Every worker owns a queue: tasks submitted from
+    outside are dealt round-robin, tasks submitted from inside a task go to the submitting worker's own queue. A
+    worker runs its newest task first and, once its queue is empty, steals the oldest task from another worker, so
+    uneven tasks (a hub station's search next to a leaf's) even out without a central queue to fight over.
+
+    ParallelFor splits ranges lazily: a range task only hands its back half to the pool while a worker is idle, so a
+    batch costs a handful of tasks when the load is even and splits down to single items when it isn't.
+
+    Wait and ParallelFor must be called from outside the pool, a task waiting on the pool it runs in would never finish.
+*/
+
+// Counters since the pool was created. Utilisation is busySeconds / (elapsedSeconds * threadCount).
+struct PoolMetrics {
+    int threadCount;
+    long long tasksRun;
+    long long tasksStolen;
+    // Range tasks that gave half their range away, see ParallelFor.
+    long long tasksSplit;
+    double elapsedSeconds;
+    // Time spent running tasks, summed over workers.
+    double busySeconds;
+};
+
+class WorkStealingPool{
+    public:
+        // threadCount 0 uses one per hardware thread.
+        WorkStealingPool(int threadCount = 0);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+        void Submit(std::function<void()> task);
+        // Blocks until every task submitted so far, and every task they submitted, has finished.
+        void Wait();
+        // Runs body(index, workerIndex) for every index in [begin, end) and waits for all of them. workerIndex is
+        // below GetThreadCount and lets callers keep scratch space per worker.
+        void ParallelFor(int begin, int end, const std::function<void(int, int)>& body);
+        int GetThreadCount() const;
+        PoolMetrics GetMetrics() const;
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct WorkerQueue {
+            std::deque<std::function<void()>> tasks;
+            std::mutex queueMutex;
+            // Only written by the queue's own worker.
+            std::atomic<long long> tasksRun{0};
+            std::atomic<long long> tasksStolen{0};
+            std::atomic<long long> busyNanos{0};
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+        Clock::time_point createdTime;
+        std::atomic<long long> tasksSplit;
+
+        // Guards the counters below, workers sleep on workAvailable while nothing is queued. queuedTasks and
+        // idleWorkers are only changed under the lock but read without it to decide whether to split.
+        std::mutex stateMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable allDone;
+        std::atomic<int> queuedTasks;
+        std::atomic<int> idleWorkers;
+        int unfinishedTasks;
+        unsigned nextQueue;
+        bool stopping;
+
+        void worker_loop(int workerIndex);
+        // Own queue newest first, then the oldest task of each other queue in turn.
+        bool try_pop(int workerIndex, std::function<void()>& task, bool& stolen);
+        void run_range(int begin, int end, const std::function<void(int, int)>& body);
+};